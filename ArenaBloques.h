@@ -0,0 +1,243 @@
+#ifndef ARENA_BLOQUES_H
+#define ARENA_BLOQUES_H
+
+#include <cstddef>  // Para size_t (C puro, sin STL)
+#include "ContadorMemoria.h"
+
+/**
+ * @brief Reparte casillas de tamanio fijo para los bloques de los historiales
+ * 
+ * Las casillas salen de trozos grandes (empiezan en 16 KB y se duplican
+ * hasta 1 MB) y las que se devuelven se reciclan. Todos los historiales
+ * de una lista de gestion comparten la misma arena, asi que al cerrar el
+ * sistema los bloques no se liberan de uno en uno: se sueltan los trozos
+ * enteros. De los mismos trozos salen, con tomarBytes(), piezas de otro
+ * tamanio (los detectores de anomalias de los sensores registrados).
+ * 
+ * No usa candados: sigue la misma regla que la lista de gestion duenia
+ * (un solo hilo escribe a sus sensores a la vez).
+ */
+class ArenaBloques {
+private:
+    /**
+     * @brief Encabezado de cada trozo pedido al contador de memoria
+     */
+    struct Trozo {
+        Trozo* siguiente;  // Trozo pedido antes
+        size_t bytes;      // Tamanio total del trozo (con este encabezado)
+    };
+    
+    /**
+     * @brief Pieza de tamanio libre devuelta (vive en la propia pieza)
+     */
+    struct Pieza {
+        Pieza* siguiente;  // Otra pieza devuelta
+        size_t bytes;      // Tamanio de esta (ya redondeado)
+    };
+    
+    static const size_t ALINEACION = 16;
+    static const size_t TROZO_INICIAL = 16 * 1024;
+    static const size_t TROZO_MAXIMO = 1024 * 1024;
+    
+    Trozo* trozos;        // Todos los trozos (el primero es el actual)
+    char* libre;          // Siguiente casilla nunca usada del trozo actual
+    char* fin;            // Fin del trozo actual
+    void* reciclados;     // Casillas devueltas (enlace en los primeros bytes)
+    Pieza* piezas;        // Piezas de tomarBytes() devueltas
+    CuentaBytes* cuenta;  // Donde anoto los trozos ademas del contador global (puede ser NULL)
+    size_t casilla;       // Bytes por casilla
+    size_t proximoTrozo;  // Tamanio del siguiente trozo a pedir
+    int enUso;            // Casillas entregadas y no devueltas
+    bool cerrando;        // Los historiales ya no devuelven sus bloques
+    
+    /**
+     * @brief Pide un trozo nuevo y lo deja como actual
+     * @param minimo Bytes que deben caber despues del encabezado
+     */
+    void nuevoTrozo(size_t minimo) {
+        size_t encabezado = (sizeof(Trozo) + ALINEACION - 1) & ~(ALINEACION - 1);
+        size_t bytes = proximoTrozo;
+        if (bytes < encabezado + minimo) bytes = encabezado + minimo;
+        Trozo* trozo = (Trozo*)ContadorMemoria::pedir(bytes);
+        if (cuenta != NULL) cuenta->sumar((long long)bytes);
+        trozo->siguiente = trozos;
+        trozo->bytes = bytes;
+        trozos = trozo;
+        libre = (char*)trozo + encabezado;
+        fin = (char*)trozo + bytes;
+        if (proximoTrozo < TROZO_MAXIMO) proximoTrozo *= 2;
+    }
+    
+    // No se copia: es duenia de sus trozos
+    ArenaBloques(const ArenaBloques&);
+    ArenaBloques& operator=(const ArenaBloques&);
+
+public:
+    /**
+     * @brief Constructor; no pide memoria hasta la primera casilla
+     * @param bytesCasilla Tamanio de cada casilla
+     */
+    explicit ArenaBloques(size_t bytesCasilla = 256)
+        : trozos(NULL), libre(NULL), fin(NULL), reciclados(NULL), piezas(NULL), cuenta(NULL),
+          casilla((bytesCasilla + ALINEACION - 1) & ~(ALINEACION - 1)),
+          proximoTrozo(TROZO_INICIAL), enUso(0), cerrando(false) {}
+    
+    /**
+     * @brief Destructor que suelta todos los trozos
+     */
+    ~ArenaBloques() {
+        liberarTodo();
+    }
+    
+    /**
+     * @brief Anota los trozos (los que ya hay y los que vengan) en una cuenta
+     * @param destino Cuenta del duenio, NULL para dejar de anotar
+     */
+    void contarEn(CuentaBytes* destino) {
+        long long reservados = (long long)bytesReservados();
+        if (cuenta != NULL) cuenta->restar(reservados);
+        cuenta = destino;
+        if (cuenta != NULL) cuenta->sumar(reservados);
+    }
+    
+    /**
+     * @brief Entrega una casilla (reciclada si hay)
+     * @return Memoria para un bloque, alineada a 16 bytes
+     */
+    void* tomar() {
+        enUso++;
+        if (reciclados != NULL) {
+            void* p = reciclados;
+            reciclados = *(void**)p;
+            return p;
+        }
+        if (libre == NULL || libre + casilla > fin) nuevoTrozo(casilla);
+        void* p = libre;
+        libre += casilla;
+        return p;
+    }
+    
+    /**
+     * @brief Recibe una casilla para reciclarla
+     * @param p Casilla obtenida con tomar()
+     */
+    void devolver(void* p) {
+        *(void**)p = reciclados;
+        reciclados = p;
+        enUso--;
+    }
+    
+    /**
+     * @brief Entrega una pieza de cualquier tamanio de los mismos trozos
+     * 
+     * Primero busco una devuelta del mismo tamanio; si no, la corto del
+     * trozo actual (o de uno nuevo, y lo que sobraba del anterior se
+     * pierde hasta liberarTodo).
+     * 
+     * @param bytes Tamanio de la pieza
+     * @return Memoria alineada a 16 bytes
+     */
+    void* tomarBytes(size_t bytes) {
+        bytes = (bytes + ALINEACION - 1) & ~(ALINEACION - 1);
+        for (Pieza** enlace = &piezas; *enlace != NULL; enlace = &(*enlace)->siguiente) {
+            if ((*enlace)->bytes == bytes) {
+                Pieza* pieza = *enlace;
+                *enlace = pieza->siguiente;
+                return pieza;
+            }
+        }
+        if (libre == NULL || libre + bytes > fin) nuevoTrozo(bytes);
+        void* p = libre;
+        libre += bytes;
+        return p;
+    }
+    
+    /**
+     * @brief Recibe una pieza de tomarBytes() para reciclarla
+     * @param p Pieza
+     * @param bytes Tamanio con el que se pidio
+     */
+    void devolverBytes(void* p, size_t bytes) {
+        Pieza* pieza = (Pieza*)p;
+        pieza->bytes = (bytes + ALINEACION - 1) & ~(ALINEACION - 1);
+        pieza->siguiente = piezas;
+        piezas = pieza;
+    }
+    
+    /**
+     * @brief Suelta todos los trozos de un golpe (las casillas dejan de valer)
+     */
+    void liberarTodo() {
+        while (trozos != NULL) {
+            Trozo* siguiente = trozos->siguiente;
+            if (cuenta != NULL) cuenta->restar((long long)trozos->bytes);
+            ContadorMemoria::devolver(trozos, trozos->bytes);
+            trozos = siguiente;
+        }
+        libre = NULL;
+        fin = NULL;
+        reciclados = NULL;
+        piezas = NULL;
+        proximoTrozo = TROZO_INICIAL;
+        enUso = 0;
+        cerrando = false;
+    }
+    
+    /**
+     * @brief Olvida los trozos sin liberarlos
+     * 
+     * Solo para la salida rapida: el sistema operativo recupera la
+     * memoria cuando termina el proceso. Los trozos no se descuentan de
+     * ContadorMemoria, asi que siguen contados como vivos.
+     */
+    void abandonar() {
+        trozos = NULL;
+        liberarTodo();
+    }
+    
+    /**
+     * @brief Avisa que toda la arena se va a soltar junta
+     * 
+     * Desde aqui los historiales no recorren sus bloques al destruirse
+     * ni los detectores devuelven sus piezas.
+     */
+    void iniciarCierre() {
+        cerrando = true;
+    }
+    
+    /**
+     * @brief Indica si la arena se esta cerrando
+     * @return true despues de iniciarCierre()
+     */
+    bool enCierre() const {
+        return cerrando;
+    }
+    
+    /**
+     * @brief Tamanio de cada casilla
+     * @return Bytes por casilla
+     */
+    size_t tamanioCasilla() const {
+        return casilla;
+    }
+    
+    /**
+     * @brief Casillas entregadas que no se han devuelto
+     * @return Cantidad de casillas
+     */
+    int casillasEnUso() const {
+        return enUso;
+    }
+    
+    /**
+     * @brief Memoria pedida en trozos
+     * @return Bytes de todos los trozos
+     */
+    size_t bytesReservados() const {
+        size_t total = 0;
+        for (const Trozo* t = trozos; t != NULL; t = t->siguiente) total += t->bytes;
+        return total;
+    }
+};
+
+#endif // ARENA_BLOQUES_H
\ No newline at end of file
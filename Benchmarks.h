@@ -0,0 +1,1745 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <cstdio>   // Para printf (C puro, sin STL)
+#include <cstdlib>  // Para atoi, malloc, free, rand
+#include <cstring>  // Para strcmp
+#include <unistd.h>    // Para fork, _exit
+#include <sys/wait.h>  // Para waitpid
+#include "Bitacora.h"
+#include "Reloj.h"
+#include "ListaGestion.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "RegistroTipos.h"
+#include "ReproduccionDiferencial.h"
+#include "PipelineIngesta.h"
+#include "HistogramaLatencia.h"
+#include "Metricas.h"
+#include "ExportadorColumnar.h"
+#include "ListaGestionFragmentada.h"
+#include "DetectorAnomalias.h"
+#include "SimuladorArduino.h"
+#include "PlanificadorDispositivos.h"
+
+/**
+ * @brief Lee un argumento entero de la linea de comandos
+ * @param argc Cantidad de argumentos
+ * @param argv Arreglo de argumentos
+ * @param indice Posicion del argumento que quiero
+ * @param defecto Valor a usar si no viene el argumento
+ * @return El valor leido o el de defecto
+ */
+inline int argumentoEntero(int argc, char** argv, int indice, int defecto) {
+    if (indice < argc) {
+        int valor = atoi(argv[indice]);
+        if (valor > 0) return valor;
+    }
+    return defecto;
+}
+
+/**
+ * @brief Mide procesarTodos cuando solo una fraccion de los sensores tiene datos
+ * 
+ * Uso: --bench perezoso [sensores] [activos_por_mil] [pasadas]
+ * Por defecto 100000 sensores con 10 por mil (1%) activos en cada pasada.
+ * Al final hago una pasada con todos activos, que equivale al costo de
+ * procesar toda la flota como se hacia antes.
+ */
+inline int benchProcesamientoPerezoso(int argc, char** argv) {
+    int cantidad = argumentoEntero(argc, argv, 0, 100000);
+    int activosPorMil = argumentoEntero(argc, argv, 1, 10);
+    int pasadas = argumentoEntero(argc, argv, 2, 20);
+    int activos = (int)((long long)cantidad * activosPorMil / 1000);
+    if (activos < 1) activos = 1;
+    
+    bitacoraActiva() = false;  // Sin printf por lectura, si no mido la consola
+    
+    ListaGestion* sistema = new ListaGestion();
+    SensorTemperatura** temperaturas = (SensorTemperatura**)malloc(sizeof(SensorTemperatura*) * cantidad);
+    SensorPresion** presiones = (SensorPresion**)malloc(sizeof(SensorPresion*) * cantidad);
+    
+    // Mitad temperatura, mitad presion
+    char id[50];
+    for (int i = 0; i < cantidad; i++) {
+        temperaturas[i] = NULL;
+        presiones[i] = NULL;
+        if (i % 2 == 0) {
+            snprintf(id, sizeof(id), "T-%07d", i);
+            temperaturas[i] = new SensorTemperatura(id);
+            sistema->agregarSensor(temperaturas[i]);
+        } else {
+            snprintf(id, sizeof(id), "P-%07d", i);
+            presiones[i] = new SensorPresion(id);
+            sistema->agregarSensor(presiones[i]);
+        }
+    }
+    
+    long long bytesFlota = (long long)sistema->obtenerBytesFlota();
+    long long asignacionesAntes = ContadorMemoria::asignaciones();
+    
+    srand(12345);
+    long long totalNs = 0;
+    int totalProcesados = 0;
+    for (int p = 0; p < pasadas; p++) {
+        // Cada pasada le llegan datos a un grupo distinto de sensores
+        for (int k = 0; k < activos; k++) {
+            int i = rand() % cantidad;
+            if (temperaturas[i] != NULL) temperaturas[i]->registrarLectura(15.0f + (rand() % 300) / 10.0f);
+            else presiones[i]->registrarLectura(70 + rand() % 41);
+        }
+        long long inicio = relojNs();
+        totalProcesados += sistema->procesarTodos();
+        totalNs += relojNs() - inicio;
+    }
+    
+    long long asignacionesPasadas = ContadorMemoria::asignaciones() - asignacionesAntes;
+    
+    // Pasada de referencia con todos los sensores activos
+    for (int i = 0; i < cantidad; i++) {
+        if (temperaturas[i] != NULL) temperaturas[i]->registrarLectura(20.0f);
+        else presiones[i]->registrarLectura(90);
+    }
+    long long inicioCompleta = relojNs();
+    int procesadosCompleta = sistema->procesarTodos();
+    long long completaNs = relojNs() - inicioCompleta;
+    
+    // Pasada sin datos nuevos: no deberia tocar ningun sensor
+    long long inicioVacia = relojNs();
+    int procesadosVacia = sistema->procesarTodos();
+    long long vaciaNs = relojNs() - inicioVacia;
+    
+    delete sistema;
+    free(temperaturas);
+    free(presiones);
+    bitacoraActiva() = true;
+    
+    printf("=== Benchmark: procesarTodos perezoso ===\n");
+    printf("Sensores registrados: %d, activos por pasada: %d (%d por mil)\n", cantidad, activos, activosPorMil);
+    printf("Pasada parcial:  %.3f ms promedio, %.1f sensores procesados promedio\n",
+           nsAMs(totalNs) / pasadas, (double)totalProcesados / pasadas);
+    printf("Pasada completa: %.3f ms (%d sensores)\n", nsAMs(completaNs), procesadosCompleta);
+    printf("Pasada sin datos: %.3f ms (%d sensores)\n", nsAMs(vaciaNs), procesadosVacia);
+    if (totalNs > 0) {
+        printf("Aceleracion parcial vs completa: %.1fx\n", (double)completaNs * pasadas / totalNs);
+    }
+    printf("Memoria de la flota al inicio: %.2f MB, asignaciones durante las pasadas: %lld\n",
+           bytesFlota / 1048576.0, asignacionesPasadas);
+    return 0;
+}
+
+/**
+ * @brief Datos que recibe cada hilo productor del benchmark del pipeline
+ */
+struct ArgumentosProductor {
+    PipelineIngesta* pipeline;
+    SensorBase** sensores;
+    int cantidadSensores;
+    int carril;
+    int lecturas;
+    long long periodoNs;  // Separacion entre lecturas (0 = tan rapido como se pueda)
+};
+
+/**
+ * @brief Hilo productor: simula un Arduino publicando lecturas al pipeline
+ * @param arg Puntero a ArgumentosProductor
+ * @return Siempre NULL
+ */
+inline void* hiloProductorBenchmark(void* arg) {
+    ArgumentosProductor* a = (ArgumentosProductor*)arg;
+    unsigned semilla = 1000u + a->carril;
+    long long inicio = relojNs();
+    for (int i = 0; i < a->lecturas; i++) {
+        if (a->periodoNs > 0) {
+            // Espero mi turno para simular un dispositivo a tasa fija; cedo
+            // el nucleo para no quitarselo al agrupador
+            long long turno = inicio + i * a->periodoNs;
+            while (relojNs() < turno) sched_yield();
+        }
+        int s = rand_r(&semilla) % a->cantidadSensores;
+        float temp = 15.0f + (rand_r(&semilla) % 300) / 10.0f;
+        a->pipeline->publicar(a->carril, a->sensores[s], temp);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Muestra percentiles de un histograma en microsegundos
+ * @param etiqueta Nombre de la ruta medida
+ * @param h Histograma en nanosegundos
+ */
+inline void imprimirPercentiles(const char* etiqueta, const HistogramaLatencia& h) {
+    printf("%s latencia p50: %.2f us, p99: %.2f us, p99.9: %.2f us, max: %.2f us\n", etiqueta,
+           h.percentil(50) / 1000.0, h.percentil(99) / 1000.0,
+           h.percentil(99.9) / 1000.0, h.obtenerMaximo() / 1000.0);
+}
+
+/**
+ * @brief Corre una ronda del pipeline sobre sensores nuevos
+ * @param config Parametros del pipeline
+ * @param cantidadSensores Sensores destino
+ * @param lecturas Lecturas por productor
+ * @param periodoNs Separacion entre lecturas de cada productor (0 = sin pausa)
+ * @param ns Salida: tiempo desde iniciar hasta que todo quedo aplicado
+ * @return El pipeline ya detenido (para su reporte); lo borra quien llama
+ */
+inline PipelineIngesta* rondaPipeline(const ConfigPipeline& config, int cantidadSensores, int lecturas,
+                                      long long periodoNs, long long& ns) {
+    ListaGestion* sistema = new ListaGestion();
+    SensorBase** sensores = (SensorBase**)malloc(sizeof(SensorBase*) * cantidadSensores);
+    char id[50];
+    for (int i = 0; i < cantidadSensores; i++) {
+        snprintf(id, sizeof(id), "T-%06d", i);
+        sensores[i] = new SensorTemperatura(id);
+        sistema->agregarSensor(sensores[i]);
+    }
+    PipelineIngesta* pipeline = new PipelineIngesta(config);
+    
+    int productores = config.productores;
+    pthread_t* hilos = (pthread_t*)malloc(sizeof(pthread_t) * productores);
+    ArgumentosProductor* argumentos = (ArgumentosProductor*)malloc(sizeof(ArgumentosProductor) * productores);
+    long long inicio = relojNs();
+    pipeline->iniciar();
+    for (int p = 0; p < productores; p++) {
+        argumentos[p].pipeline = pipeline;
+        argumentos[p].sensores = sensores;
+        argumentos[p].cantidadSensores = cantidadSensores;
+        argumentos[p].carril = p;
+        argumentos[p].lecturas = lecturas;
+        argumentos[p].periodoNs = periodoNs;
+        pthread_create(&hilos[p], NULL, hiloProductorBenchmark, &argumentos[p]);
+    }
+    for (int p = 0; p < productores; p++) {
+        pthread_join(hilos[p], NULL);
+    }
+    pipeline->vaciar();
+    ns = relojNs() - inicio;
+    pipeline->detener();
+    
+    delete sistema;
+    free(sensores);
+    free(hilos);
+    free(argumentos);
+    return pipeline;
+}
+
+/**
+ * @brief Compara la ruta directa (registrarLectura en el hilo que lee) contra el pipeline
+ * 
+ * Uso: --bench pipeline [productores] [lecturas_por_productor] [sensores] [lote] [espera_us] [tasa]
+ * 
+ * Corre el pipeline dos veces. Saturado (los productores publican sin
+ * pausa) da el rendimiento maximo; ahi la latencia es sobre todo espera
+ * en los carriles llenos. Despues con carga ofrecida por debajo de la
+ * saturacion: "tasa" lecturas por segundo por productor, o si no se da,
+ * la mitad del rendimiento saturado. Esa es la latencia de punta a punta
+ * que vale reportar.
+ */
+inline int benchPipeline(int argc, char** argv) {
+    int productores = argumentoEntero(argc, argv, 0, 4);
+    int lecturas = argumentoEntero(argc, argv, 1, 500000);
+    int cantidadSensores = argumentoEntero(argc, argv, 2, 1000);
+    int tamanioLote = argumentoEntero(argc, argv, 3, 1024);
+    int esperaUs = argumentoEntero(argc, argv, 4, 200);
+    int tasa = argumentoEntero(argc, argv, 5, 0);
+    long long total = (long long)productores * lecturas;
+    
+    bitacoraActiva() = false;
+    
+    // --- Ruta directa: un hilo, una lectura a la vez ---
+    ListaGestion* directo = new ListaGestion();
+    SensorTemperatura** sensoresDirectos = (SensorTemperatura**)malloc(sizeof(SensorTemperatura*) * cantidadSensores);
+    char id[50];
+    for (int i = 0; i < cantidadSensores; i++) {
+        snprintf(id, sizeof(id), "T-%06d", i);
+        sensoresDirectos[i] = new SensorTemperatura(id);
+        directo->agregarSensor(sensoresDirectos[i]);
+    }
+    HistogramaLatencia latenciaDirecta;
+    unsigned semilla = 1000u;
+    long long inicioDirecto = relojNs();
+    for (long long i = 0; i < total; i++) {
+        int s = rand_r(&semilla) % cantidadSensores;
+        float temp = 15.0f + (rand_r(&semilla) % 300) / 10.0f;
+        long long t0 = relojNs();
+        sensoresDirectos[s]->registrarLectura(temp);
+        latenciaDirecta.registrar(relojNs() - t0);
+    }
+    long long directoNs = relojNs() - inicioDirecto;
+    
+    // --- Pipeline: productores -> agrupador -> historiales ---
+    ConfigPipeline config;
+    config.productores = productores;
+    config.tamanioLote = tamanioLote;
+    config.esperaMaximaNs = esperaUs * 1000LL;
+    long long saturadoNs = 0;
+    PipelineIngesta* saturado = rondaPipeline(config, cantidadSensores, lecturas, 0, saturadoNs);
+    double maximo = total / (saturadoNs / 1e9);
+    
+    // Por debajo de la saturacion
+    double porProductor = tasa > 0 ? (double)tasa : maximo / 2 / productores;
+    long long medidoNs = 0;
+    PipelineIngesta* medido = rondaPipeline(config, cantidadSensores, lecturas,
+                                            (long long)(1e9 / porProductor), medidoNs);
+    
+    printf("=== Benchmark: ingesta directa vs pipeline ===\n");
+    printf("Lecturas: %lld sobre %d sensores, carriles de %d lecturas\n", total, cantidadSensores,
+           config.capacidadCarril);
+    printf("Directa:  %.0f lecturas/s (1 hilo)\n", total / (directoNs / 1e9));
+    imprimirPercentiles("Directa: ", latenciaDirecta);
+    printf("Pipeline saturado: %.0f lecturas/s (%d productores sin pausa)\n", maximo, productores);
+    imprimirPercentiles("Saturado:", saturado->obtenerLatencias());
+    printf("Pipeline a %.0f lecturas/s ofrecidas (%.0f%% del saturado), logradas %.0f:\n",
+           porProductor * productores, 100.0 * porProductor * productores / maximo, total / (medidoNs / 1e9));
+    medido->imprimirReporte();
+    
+    delete saturado;
+    delete medido;
+    delete directo;
+    free(sensoresDirectos);
+    bitacoraActiva() = true;
+    return 0;
+}
+
+/**
+ * @brief Carga de trabajo mixta para medir el costo de las metricas
+ * 
+ * Alterna metricas encendidas y apagadas cada TRAMO lecturas sobre la
+ * misma lista (encendida, apagada, apagada, encendida, ...) para que los
+ * dos lados vean la misma memoria y la deriva de la maquina se cancele.
+ * Solo cuentan grupos completos de cuatro tramos, para que los dos lados
+ * sumen las mismas lecturas. procesarTodos corre entre tramos y no se
+ * cronometra, y el grupo que le sigue (con el cache frio) tampoco cuenta.
+ * 
+ * @param sistema Lista de gestion con los sensores
+ * @param sensores Sensores de temperatura registrados en el sistema
+ * @param cantidad Cuantos sensores hay
+ * @param lecturas Lecturas a registrar en total
+ * @param conNs Se le suma el tiempo de los tramos con metricas
+ * @param sinNs Se le suma el tiempo de los tramos sin metricas
+ */
+inline void cargaMixta(ListaGestion* sistema, SensorTemperatura** sensores, int cantidad, int lecturas,
+                       long long& conNs, long long& sinNs) {
+    const int TRAMO = 8192;
+    unsigned semilla = 777u;
+    for (int base = 0; base < lecturas; base += TRAMO) {
+        int fase = (base / TRAMO) % 4;
+        bool encendidas = fase == 0 || fase == 3;
+        int fin = base + TRAMO < lecturas ? base + TRAMO : lecturas;
+        Metricas::activas() = encendidas;
+        long long inicio = relojNs();
+        for (int i = base; i < fin; i++) {
+            int s = rand_r(&semilla) % cantidad;
+            sensores[s]->registrarLectura(15.0f + (rand_r(&semilla) % 300) / 10.0f);
+            if (i % 64 == 0) sistema->buscarSensor(sensores[s]->obtenerNombre());
+        }
+        long long ns = relojNs() - inicio;
+        int grupo = base - fase * TRAMO;
+        if (grupo % 262144 == 0 || grupo + 4 * TRAMO > lecturas) {
+            // Recien creada o recien procesada (cache frio), o grupo incompleto: no cuenta
+        } else if (encendidas) {
+            conNs += ns;
+        } else {
+            sinNs += ns;
+        }
+        if (fin % 262144 == 0) sistema->procesarTodos();
+    }
+    sistema->procesarTodos();
+}
+
+/**
+ * @brief Compara la misma carga con metricas encendidas y apagadas
+ * 
+ * Uso: --bench metricas [sensores] [lecturas] [repeticiones]
+ * La primera repeticion solo calienta el allocador y no cuenta. En cada
+ * repeticion los tramos alternan encendidas/apagadas (ver cargaMixta) y
+ * reporto la mediana de los sobrecostos, asi una repeticion atipica no
+ * mueve el resultado.
+ * 
+ * @return 0 si el sobrecosto queda bajo el 2%, 1 si no
+ */
+inline int benchMetricas(int argc, char** argv) {
+    int cantidad = argumentoEntero(argc, argv, 0, 200);
+    int lecturas = argumentoEntero(argc, argv, 1, 1000000);
+    int repeticiones = argumentoEntero(argc, argv, 2, 21);
+    const double LIMITE = 2.0;  // Sobrecosto maximo aceptado, en %
+    if (repeticiones < 1) repeticiones = 1;
+    
+    bitacoraActiva() = false;
+    long long conTotal = 0;
+    long long sinTotal = 0;
+    double* sobrecostos = (double*)malloc(sizeof(double) * repeticiones);
+    char id[50];
+    for (int r = -1; r < repeticiones; r++) {
+        ListaGestion* sistema = new ListaGestion();
+        SensorTemperatura** sensores = (SensorTemperatura**)malloc(sizeof(SensorTemperatura*) * cantidad);
+        for (int i = 0; i < cantidad; i++) {
+            snprintf(id, sizeof(id), "T-%05d", i);
+            sensores[i] = new SensorTemperatura(id);
+            sistema->agregarSensor(sensores[i]);
+        }
+        long long conNs = 0;
+        long long sinNs = 0;
+        cargaMixta(sistema, sensores, cantidad, lecturas, conNs, sinNs);
+        if (r >= 0) {  // La corrida -1 es de calentamiento
+            conTotal += conNs;
+            sinTotal += sinNs;
+            sobrecostos[r] = 100.0 * (conNs - sinNs) / sinNs;
+        }
+        delete sistema;
+        free(sensores);
+    }
+    Metricas::activas() = true;
+    bitacoraActiva() = true;
+    
+    // Mediana (insercion: son pocas)
+    for (int i = 1; i < repeticiones; i++) {
+        double v = sobrecostos[i];
+        int j = i - 1;
+        while (j >= 0 && sobrecostos[j] > v) {
+            sobrecostos[j + 1] = sobrecostos[j];
+            j--;
+        }
+        sobrecostos[j + 1] = v;
+    }
+    double sobrecosto = repeticiones % 2 == 1
+        ? sobrecostos[repeticiones / 2]
+        : (sobrecostos[repeticiones / 2 - 1] + sobrecostos[repeticiones / 2]) / 2.0;
+    free(sobrecostos);
+    
+    printf("=== Benchmark: costo de las metricas ===\n");
+    printf("Sin metricas: %.1f ms por corrida\n", nsAMs(sinTotal) / repeticiones);
+    printf("Con metricas: %.1f ms por corrida\n", nsAMs(conTotal) / repeticiones);
+    printf("Sobrecosto: %.2f%% (mediana de %d repeticiones, limite %.0f%%) -> %s\n",
+           sobrecosto, repeticiones, LIMITE, sobrecosto <= LIMITE ? "OK" : "EXCEDIDO");
+    Metricas::imprimirReporte();
+    return sobrecosto <= LIMITE ? 0 : 1;
+}
+
+/**
+ * @brief Visitante que suma lecturas y valores para comparar dos flotas
+ * @param sensor Sensor visitado
+ * @param contexto Arreglo de dos double: [0] lecturas, [1] suma de valores
+ */
+inline void sumarHistorial(SensorBase* sensor, void* contexto) {
+    double* totales = (double*)contexto;
+    double bloque[1024];
+    CursorLecturas cursor;
+    int n;
+    while ((n = sensor->copiarLecturas(bloque, 1024, cursor)) > 0) {
+        for (int i = 0; i < n; i++) totales[1] += bloque[i];
+        totales[0] += n;
+    }
+}
+
+/**
+ * @brief Mide exportacion e importacion del formato por columnas
+ * 
+ * Uso: --bench exportar [lecturas] [sensores] [ruta]
+ * Por defecto 1e8 lecturas: los historiales van en bloques (unos 4.3
+ * bytes por lectura), asi que origen y destino juntos ocupan unos 820 MB
+ * mas el archivo de unos 240 MB.
+ */
+inline int benchExportar(int argc, char** argv) {
+    int lecturas = argumentoEntero(argc, argv, 0, 100000000);
+    int cantidad = argumentoEntero(argc, argv, 1, 1000);
+    const char* ruta = argc > 2 ? argv[2] : "/tmp/sensores_bench.siot";
+    
+    bitacoraActiva() = false;
+    ListaGestion* origen = new ListaGestion();
+    SensorBase** sensores = (SensorBase**)malloc(sizeof(SensorBase*) * cantidad);
+    char id[50];
+    for (int i = 0; i < cantidad; i++) {
+        if (i % 2 == 0) {
+            snprintf(id, sizeof(id), "T-%06d", i);
+            sensores[i] = new SensorTemperatura(id);
+        } else {
+            snprintf(id, sizeof(id), "P-%06d", i);
+            sensores[i] = new SensorPresion(id);
+        }
+        origen->agregarSensor(sensores[i]);
+    }
+    
+    // Lleno los historiales en lotes, con valores parecidos a los del Arduino
+    double lote[4096];
+    unsigned semilla = 42u;
+    int porSensor = lecturas / cantidad;
+    for (int i = 0; i < cantidad; i++) {
+        bool entero = (i % 2 == 1);
+        for (int hechas = 0; hechas < porSensor; hechas += 4096) {
+            int n = porSensor - hechas < 4096 ? porSensor - hechas : 4096;
+            for (int j = 0; j < n; j++) {
+                lote[j] = entero ? 70 + rand_r(&semilla) % 41 : 15.0f + (rand_r(&semilla) % 300) / 10.0f;
+            }
+            sensores[i]->registrarLote(lote, n);
+        }
+    }
+    long long total = (long long)porSensor * cantidad;
+    
+    long long inicio = relojNs();
+    long long bytes = ExportadorColumnar::exportar(*origen, ruta);
+    long long exportarNs = relojNs() - inicio;
+    
+    ListaGestion* destino = new ListaGestion();
+    inicio = relojNs();
+    long long cargadas = ExportadorColumnar::importar(*destino, ruta);
+    long long importarNs = relojNs() - inicio;
+    
+    double sumaOrigen[2] = { 0, 0 };
+    double sumaDestino[2] = { 0, 0 };
+    origen->paraCadaSensor(sumarHistorial, sumaOrigen);
+    destino->paraCadaSensor(sumarHistorial, sumaDestino);
+    
+    delete origen;
+    delete destino;
+    free(sensores);
+    bitacoraActiva() = true;
+    
+    // Tamanio "crudo": id de 4 bytes + tipo de 1 + tiempo de 8 + valor de 8 por lectura
+    double crudoMB = total * 21.0 / 1048576.0;
+    printf("=== Benchmark: exportacion por columnas ===\n");
+    printf("Lecturas: %lld en %d sensores, archivo: %s\n", total, cantidad, ruta);
+    if (bytes < 0 || cargadas < 0) {
+        printf("Error al exportar o importar\n");
+        return 1;
+    }
+    printf("Archivo: %.1f MB (%.2f bytes por lectura, %.1fx contra %.1f MB crudos)\n",
+           bytes / 1048576.0, (double)bytes / total, crudoMB * 1048576.0 / bytes, crudoMB);
+    printf("Exportar: %.1f ms, %.1f MB/s de archivo, %.1f MB/s crudos, %.1f M lecturas/s\n",
+           nsAMs(exportarNs), bytes / 1048576.0 / (exportarNs / 1e9), crudoMB / (exportarNs / 1e9),
+           total / 1e6 / (exportarNs / 1e9));
+    printf("Importar: %.1f ms, %.1f MB/s de archivo, %.1f MB/s crudos, %.1f M lecturas/s\n",
+           nsAMs(importarNs), bytes / 1048576.0 / (importarNs / 1e9), crudoMB / (importarNs / 1e9),
+           cargadas / 1e6 / (importarNs / 1e9));
+    printf("Verificacion: %.0f/%.0f lecturas, suma %.3f/%.3f -> %s\n",
+           sumaOrigen[0], sumaDestino[0], sumaOrigen[1], sumaDestino[1],
+           (sumaOrigen[0] == sumaDestino[0] && sumaOrigen[1] == sumaDestino[1]) ? "OK" : "DIFERENTE");
+    return 0;
+}
+
+/**
+ * @brief Tiempos de una instanciacion de ListaSensor
+ */
+struct TiemposLista {
+    long long insertarNs;   // insertarAlFinal uno por uno
+    long long loteNs;       // insertarLote en lotes de 1024
+    long long promedioNs;   // calcularPromedio (todas las pasadas)
+    long long copiarNs;     // copiarComo a double (todas las pasadas)
+    long long eliminarNs;   // extraerMinimo repetido
+    double promedio;        // Resultado para comparar instanciaciones
+    double sumaMinimos;     // Suma de los minimos extraidos
+};
+
+/**
+ * @brief Corre las operaciones de la lista sobre los mismos datos
+ * @tparam Lista Instanciacion de ListaSensor a medir
+ * @tparam T Tipo de dato de la lista
+ * @param datos Lecturas a insertar
+ * @param cantidad Cuantas lecturas hay
+ * @param pasadas Veces que repito promedio y copia
+ * @param extracciones Cuantos minimos extraigo
+ * @return Tiempos y resultados
+ */
+template <typename Lista, typename T>
+TiemposLista medirLista(const T* datos, int cantidad, int pasadas, int extracciones) {
+    TiemposLista t;
+    Lista* uno = new Lista();
+    long long inicio = relojNs();
+    for (int i = 0; i < cantidad; i++) uno->insertarAlFinal(datos[i]);
+    t.insertarNs = relojNs() - inicio;
+    delete uno;
+    
+    Lista* lista = new Lista();
+    inicio = relojNs();
+    for (int i = 0; i < cantidad; i += 1024) {
+        lista->insertarLote(datos + i, cantidad - i < 1024 ? cantidad - i : 1024);
+    }
+    t.loteNs = relojNs() - inicio;
+    
+    inicio = relojNs();
+    t.promedio = 0.0;
+    for (int p = 0; p < pasadas; p++) t.promedio = lista->calcularPromedio();
+    t.promedioNs = relojNs() - inicio;
+    
+    double bloque[4096];
+    double sumaCopia = 0.0;
+    inicio = relojNs();
+    for (int p = 0; p < pasadas; p++) {
+        CursorLecturas cursor;
+        int n;
+        while ((n = lista->copiarComo(bloque, 4096, cursor)) > 0) sumaCopia += bloque[n - 1];
+    }
+    t.copiarNs = relojNs() - inicio;
+    
+    t.sumaMinimos = 0.0;
+    T minimo;
+    inicio = relojNs();
+    for (int e = 0; e < extracciones && lista->extraerMinimo(minimo); e++) t.sumaMinimos += minimo;
+    t.eliminarNs = relojNs() - inicio;
+    
+    delete lista;
+    if (sumaCopia < 0) printf(" ");  // Evito que el compilador quite la copia
+    return t;
+}
+
+/**
+ * @brief Imprime los tiempos de una instanciacion y su aceleracion
+ * @param etiqueta Nombre de la instanciacion
+ * @param t Tiempos medidos
+ * @param base Tiempos de la lista generica (para la aceleracion)
+ */
+inline void imprimirTiemposLista(const char* etiqueta, const TiemposLista& t, const TiemposLista& base) {
+    printf("%-22s %9.1f %9.1f %9.1f %9.1f %9.1f\n", etiqueta,
+           nsAMs(t.insertarNs), nsAMs(t.loteNs), nsAMs(t.promedioNs),
+           nsAMs(t.copiarNs), nsAMs(t.eliminarNs));
+    if (&t != &base) {
+        printf("%-22s %8.1fx %8.1fx %8.1fx %8.1fx %8.1fx\n", "  aceleracion",
+               (double)base.insertarNs / t.insertarNs, (double)base.loteNs / t.loteNs,
+               (double)base.promedioNs / t.promedioNs, (double)base.copiarNs / t.copiarNs,
+               (double)base.eliminarNs / t.eliminarNs);
+    }
+}
+
+/**
+ * @brief Compara la lista generica contra la especializada por bloques
+ * 
+ * Uso: --bench plantillas [lecturas] [pasadas] [extracciones]
+ * Mide float e int con ListaSensor<T, false> (un nodo por dato) y con
+ * ListaSensor<T> (lo que eligen los rasgos), y verifica que den lo mismo.
+ */
+inline int benchPlantillas(int argc, char** argv) {
+    int cantidad = argumentoEntero(argc, argv, 0, 1000000);
+    int pasadas = argumentoEntero(argc, argv, 1, 20);
+    int extracciones = argumentoEntero(argc, argv, 2, 200);
+    
+    float* flotantes = (float*)malloc(sizeof(float) * cantidad);
+    int* enteros = (int*)malloc(sizeof(int) * cantidad);
+    unsigned semilla = 31u;
+    for (int i = 0; i < cantidad; i++) {
+        flotantes[i] = 15.0f + (rand_r(&semilla) % 300) / 10.0f;
+        enteros[i] = 70 + rand_r(&semilla) % 41;
+    }
+    
+    bitacoraActiva() = false;
+    Metricas::activas() = false;
+    TiemposLista floatGenerica = medirLista<ListaSensor<float, false> >(flotantes, cantidad, pasadas, extracciones);
+    TiemposLista floatBloques = medirLista<ListaSensor<float> >(flotantes, cantidad, pasadas, extracciones);
+    TiemposLista intGenerica = medirLista<ListaSensor<int, false> >(enteros, cantidad, pasadas, extracciones);
+    TiemposLista intBloques = medirLista<ListaSensor<int> >(enteros, cantidad, pasadas, extracciones);
+    Metricas::activas() = true;
+    bitacoraActiva() = true;
+    free(flotantes);
+    free(enteros);
+    
+    printf("=== Benchmark: ListaSensor generica contra bloques ===\n");
+    printf("%d lecturas, %d pasadas de promedio/copia, %d extracciones de minimo\n",
+           cantidad, pasadas, extracciones);
+    printf("Bloques de %d floats y %d ints (%d bytes)\n", RasgosLectura<float>::DATOS_POR_BLOQUE,
+           RasgosLectura<int>::DATOS_POR_BLOQUE, (int)sizeof(BloqueLecturas<float>));
+    printf("%-22s %9s %9s %9s %9s %9s\n", "Tiempos en ms", "insertar", "lote", "promedio", "copiar", "minimos");
+    imprimirTiemposLista("float generica", floatGenerica, floatGenerica);
+    imprimirTiemposLista("float bloques", floatBloques, floatGenerica);
+    imprimirTiemposLista("int generica", intGenerica, intGenerica);
+    imprimirTiemposLista("int bloques", intBloques, intGenerica);
+    
+    bool iguales = floatGenerica.promedio == floatBloques.promedio &&
+                   floatGenerica.sumaMinimos == floatBloques.sumaMinimos &&
+                   intGenerica.promedio == intBloques.promedio &&
+                   intGenerica.sumaMinimos == intBloques.sumaMinimos;
+    printf("Verificacion: promedios y minimos %s\n", iguales ? "iguales -> OK" : "DIFERENTES");
+    return iguales ? 0 : 1;
+}
+
+/**
+ * @brief Parametros de un hilo del benchmark de fragmentos
+ */
+struct ArgsFragmentos {
+    ListaGestionFragmentada* registro;  // Registro compartido
+    const char (*nombres)[16];          // IDs de los sensores precargados
+    int sensores;                       // Cuantos IDs hay
+    int operaciones;                    // Operaciones que hace este hilo
+    int hilo;                           // Numero de hilo (para IDs nuevos y semilla)
+    long long encontrados;              // Busquedas e ingestas que encontraron su sensor
+};
+
+/**
+ * @brief Hilo con carga mixta: 5% registros, 30% busquedas, 65% ingestas
+ * @param arg Apuntador a ArgsFragmentos
+ * @return Siempre NULL
+ */
+inline void* hiloFragmentos(void* arg) {
+    ArgsFragmentos* a = (ArgsFragmentos*)arg;
+    unsigned semilla = 1000u + a->hilo;
+    double lote[8];
+    char id[50];
+    int nuevos = 0;
+    for (int i = 0; i < a->operaciones; i++) {
+        int tipo = rand_r(&semilla) % 100;
+        const char* elegido = a->nombres[rand_r(&semilla) % a->sensores];
+        if (tipo < 5) {
+            snprintf(id, sizeof(id), "H%02d-%07d", a->hilo, nuevos++);
+            a->registro->agregarSensor(new SensorTemperatura(id));
+        } else if (tipo < 35) {
+            if (a->registro->buscarSensor(elegido) != NULL) a->encontrados++;
+        } else {
+            for (int j = 0; j < 8; j++) lote[j] = 15.0 + (rand_r(&semilla) % 300) / 10.0;
+            if (a->registro->ingerir(elegido, lote, 8)) a->encontrados++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Corre la carga mixta con cierto numero de hilos y fragmentos
+ * @param nombres IDs de los sensores precargados
+ * @param sensores Cuantos IDs hay
+ * @param fragmentos Fragmentos del registro (1 equivale a un candado global)
+ * @param hilos Hilos que trabajan al mismo tiempo
+ * @param operaciones Operaciones por hilo
+ * @param procesarNs Donde dejo lo que tardo el procesarTodos final
+ * @return Tiempo de la carga en nanosegundos
+ */
+inline long long correrFragmentos(const char (*nombres)[16], int sensores, int fragmentos,
+                                  int hilos, int operaciones, long long* procesarNs) {
+    ListaGestionFragmentada* registro = new ListaGestionFragmentada(fragmentos);
+    for (int i = 0; i < sensores; i++) {
+        if (i % 2 == 0) {
+            registro->agregarSensor(new SensorTemperatura(nombres[i]));
+        } else {
+            registro->agregarSensor(new SensorPresion(nombres[i]));
+        }
+    }
+    
+    ArgsFragmentos* args = (ArgsFragmentos*)malloc(sizeof(ArgsFragmentos) * hilos);
+    pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t) * hilos);
+    long long inicio = relojNs();
+    for (int h = 0; h < hilos; h++) {
+        args[h].registro = registro;
+        args[h].nombres = nombres;
+        args[h].sensores = sensores;
+        args[h].operaciones = operaciones;
+        args[h].hilo = h;
+        args[h].encontrados = 0;
+        pthread_create(&ids[h], NULL, hiloFragmentos, &args[h]);
+    }
+    for (int h = 0; h < hilos; h++) pthread_join(ids[h], NULL);
+    long long ns = relojNs() - inicio;
+    
+    inicio = relojNs();
+    registro->procesarTodos();
+    *procesarNs = relojNs() - inicio;
+    
+    delete registro;
+    free(args);
+    free(ids);
+    return ns;
+}
+
+/**
+ * @brief Escalamiento del registro fragmentado contra un candado global
+ * 
+ * Uso: --bench fragmentos [hilos_max] [operaciones_por_hilo] [sensores] [fragmentos]
+ * Para 1, 2, 4... hasta hilos_max hilos corro la misma carga mixta con un
+ * solo fragmento (todo detras de un candado) y con varios fragmentos.
+ * Cada hilo hace el mismo numero de operaciones, asi que si escala bien
+ * las operaciones por segundo suben con los hilos.
+ */
+inline int benchFragmentos(int argc, char** argv) {
+    int hilosMax = argumentoEntero(argc, argv, 0, 32);
+    int operaciones = argumentoEntero(argc, argv, 1, 200000);
+    int sensores = argumentoEntero(argc, argv, 2, 20000);
+    int fragmentos = argumentoEntero(argc, argv, 3, 64);
+    
+    char (*nombres)[16] = (char(*)[16])malloc(16 * (size_t)sensores);
+    for (int i = 0; i < sensores; i++) {
+        snprintf(nombres[i], 16, "%c-%06d", i % 2 == 0 ? 'T' : 'P', i);
+    }
+    
+    bitacoraActiva() = false;
+    printf("=== Benchmark: registro fragmentado (%d sensores, %d ops por hilo, %ld nucleos) ===\n",
+           sensores, operaciones, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%6s %16s %16s %10s %14s\n", "Hilos", "1 frag Mops/s", "N frag Mops/s", "Mejora", "procesar ms");
+    for (int hilos = 1; hilos <= hilosMax; hilos *= 2) {
+        long long procesarGlobal = 0;
+        long long procesarFrag = 0;
+        long long globalNs = correrFragmentos(nombres, sensores, 1, hilos, operaciones, &procesarGlobal);
+        long long fragNs = correrFragmentos(nombres, sensores, fragmentos, hilos, operaciones, &procesarFrag);
+        double total = (double)hilos * operaciones;
+        printf("%6d %16.2f %16.2f %9.2fx %6.1f/%-7.1f\n", hilos,
+               total / 1e6 / (globalNs / 1e9), total / 1e6 / (fragNs / 1e9),
+               (double)globalNs / fragNs, nsAMs(procesarGlobal), nsAMs(procesarFrag));
+    }
+    bitacoraActiva() = true;
+    printf("(N = %d fragmentos; procesar ms = procesarTodos con 1 / N fragmentos)\n", fragmentos);
+    free(nombres);
+    return 0;
+}
+
+/**
+ * @brief Pasa una serie completa por un detector en lotes de 1024
+ * @param detector Detector a usar
+ * @param serie Lecturas
+ * @param cantidad Cuantas lecturas
+ * @param aceptadas Salida de filtrar (cabe cantidad)
+ * @param marcas Salida de marcas por lectura (cabe cantidad)
+ * @return Tiempo en nanosegundos
+ */
+inline long long correrDetector(DetectorAnomalias* detector, const double* serie, int cantidad,
+                                double* aceptadas, unsigned char* marcas) {
+    long long inicio = relojNs();
+    int salida = 0;
+    for (int i = 0; i < cantidad; i += 1024) {
+        int n = cantidad - i < 1024 ? cantidad - i : 1024;
+        salida += detector->filtrar(serie + i, n, aceptadas + salida, marcas + i);
+    }
+    return relojNs() - inicio;
+}
+
+/**
+ * @brief Mide el detector de anomalias y que tan bien encuentra los picos
+ * 
+ * Uso: --bench anomalias [lecturas] [picos_por_mil] [sensores]
+ * Genera una serie de temperatura con picos inyectados (como el
+ * simulador del Arduino), la pasa por el detector solo y luego por
+ * registrarLote de varios sensores con y sin deteccion.
+ */
+inline int benchAnomalias(int argc, char** argv) {
+    int cantidad = argumentoEntero(argc, argv, 0, 10000000);
+    int picosPorMil = argumentoEntero(argc, argv, 1, 5);
+    int numSensores = argumentoEntero(argc, argv, 2, 100);
+    
+    double* serie = (double*)malloc(sizeof(double) * cantidad);
+    double* aceptadas = (double*)malloc(sizeof(double) * cantidad);
+    unsigned char* esPico = (unsigned char*)malloc(cantidad);
+    unsigned char* marcas = (unsigned char*)malloc(cantidad);
+    int picos = SimuladorArduino::generarSerieConPicos(serie, cantidad, 25.0, 0.5, picosPorMil,
+                                                       12.0, esPico, 2024u);
+    
+    // 1) Solo el detector, en cuarentena
+    DetectorAnomalias* detector = new DetectorAnomalias(SensorTemperatura::configDetector());
+    long long cuarentenaNs = correrDetector(detector, serie, cantidad, aceptadas, marcas);
+    int detectados = 0;
+    int falsos = 0;
+    for (int i = 0; i < cantidad; i++) {
+        if (marcas[i] != 0 && esPico[i]) detectados++;
+        if (marcas[i] != 0 && !esPico[i]) falsos++;
+    }
+    printf("=== Benchmark: deteccion de anomalias ===\n");
+    printf("Serie: %d lecturas, %d picos inyectados de +-12 C\n", cantidad, picos);
+    printf("Detector (cuarentena): %.1f ms, %.1f M lecturas/s\n",
+           nsAMs(cuarentenaNs), cantidad / 1e6 / (cuarentenaNs / 1e9));
+    printf("Picos detectados: %d de %d (%.2f%%), falsos positivos: %d (%.4f%%)\n",
+           detectados, picos, picos == 0 ? 100.0 : 100.0 * detectados / picos,
+           falsos, 100.0 * falsos / cantidad);
+    detector->imprimirResumen();
+    delete detector;
+    
+    // 2) Solo marcando (todo llega al historial)
+    ConfigDetector soloMarcar = SensorTemperatura::configDetector();
+    soloMarcar.cuarentena = false;
+    detector = new DetectorAnomalias(soloMarcar);
+    long long marcarNs = correrDetector(detector, serie, cantidad, aceptadas, marcas);
+    printf("Detector (solo marcar): %.1f ms, %.1f M lecturas/s\n",
+           nsAMs(marcarNs), cantidad / 1e6 / (marcarNs / 1e9));
+    delete detector;
+    
+    // 3) De punta a punta: registrarLote en varios sensores con y sin detector
+    bitacoraActiva() = false;
+    long long tiempos[2] = { 0, 0 };
+    for (int conDetector = 0; conDetector < 2; conDetector++) {
+        ListaGestion* sistema = new ListaGestion();
+        SensorTemperatura** sensores = (SensorTemperatura**)malloc(sizeof(SensorTemperatura*) * numSensores);
+        char id[50];
+        for (int i = 0; i < numSensores; i++) {
+            snprintf(id, sizeof(id), "T-%05d", i);
+            sensores[i] = new SensorTemperatura(id);
+            if (conDetector) sensores[i]->activarDeteccion();
+            sistema->agregarSensor(sensores[i]);
+        }
+        long long inicio = relojNs();
+        for (int i = 0, s = 0; i < cantidad; i += 1024, s = (s + 1) % numSensores) {
+            sensores[s]->registrarLote(serie + i, cantidad - i < 1024 ? cantidad - i : 1024);
+        }
+        tiempos[conDetector] = relojNs() - inicio;
+        delete sistema;
+        free(sensores);
+    }
+    bitacoraActiva() = true;
+    printf("registrarLote sin detector: %.1f ms, %.1f M lecturas/s\n",
+           nsAMs(tiempos[0]), cantidad / 1e6 / (tiempos[0] / 1e9));
+    printf("registrarLote con detector: %.1f ms, %.1f M lecturas/s (%d sensores)\n",
+           nsAMs(tiempos[1]), cantidad / 1e6 / (tiempos[1] / 1e9), numSensores);
+    
+    free(serie);
+    free(aceptadas);
+    free(esPico);
+    free(marcas);
+    return 0;
+}
+
+/**
+ * @brief Escribe un manifiesto de prueba "ID TIPO" por renglon
+ * @param ruta Archivo destino
+ * @param cantidad Cuantos sensores
+ * @param cambio Cada cuantos sensores hay uno quitado, uno con otro tipo y uno nuevo (0 = ninguno)
+ * @return true si se pudo escribir
+ */
+inline bool escribirManifiesto(const char* ruta, int cantidad, int cambio) {
+    FILE* archivo = fopen(ruta, "w");
+    if (archivo == NULL) return false;
+    fprintf(archivo, "# Manifiesto de prueba: ID TIPO\n");
+    for (int i = 0; i < cantidad; i++) {
+        char tipo = i % 2 == 0 ? 'T' : 'P';
+        if (cambio > 0 && i % cambio == 0) continue;                   // Se va
+        if (cambio > 0 && i % cambio == 1) tipo = tipo == 'T' ? 'P' : 'T';  // Cambia de tipo
+        fprintf(archivo, "S-%07d %c\n", i, tipo);
+        if (cambio > 0 && i % cambio == 2) fprintf(archivo, "N-%07d %c\n", i, tipo);  // Llega
+    }
+    fclose(archivo);
+    return true;
+}
+
+/**
+ * @brief Cuenta cuantos IDs del manifiesto de prueba se encuentran
+ * @param sistema Lista de gestion
+ * @param cantidad Sensores del manifiesto
+ * @param cambio El mismo valor con el que se escribio
+ * @return Sensores encontrados con el tipo esperado
+ */
+inline int verificarManifiesto(ListaGestion* sistema, int cantidad, int cambio) {
+    int encontrados = 0;
+    char id[50];
+    for (int i = 0; i < cantidad; i++) {
+        char tipo = i % 2 == 0 ? 'T' : 'P';
+        if (cambio > 0 && i % cambio == 1) tipo = tipo == 'T' ? 'P' : 'T';
+        snprintf(id, sizeof(id), "S-%07d", i);
+        SensorBase* sensor = sistema->buscarSensor(id);
+        bool debeEstar = !(cambio > 0 && i % cambio == 0);
+        if ((sensor != NULL) == debeEstar && (sensor == NULL || sensor->obtenerTipo() == tipo)) encontrados++;
+        if (cambio > 0 && i % cambio == 2) {
+            snprintf(id, sizeof(id), "N-%07d", i);
+            encontrados += sistema->buscarSensor(id) != NULL;
+        }
+    }
+    return encontrados;
+}
+
+/**
+ * @brief Mide la carga masiva de sensores desde un manifiesto
+ * 
+ * Uso: --bench manifiesto [sensores] [ruta]
+ * Compara registrar uno por uno con agregarSensor contra
+ * cargarManifiesto, y luego mide una recarga donde el 1% se va, el 1%
+ * cambia de tipo y llega un 1% nuevo.
+ */
+inline int benchManifiesto(int argc, char** argv) {
+    int cantidad = argumentoEntero(argc, argv, 0, 1000000);
+    const char* ruta = argc > 1 ? argv[1] : "/tmp/sensores_manifiesto.txt";
+    const int cambio = 100;
+    
+    printf("=== Benchmark: carga de sensores por manifiesto ===\n");
+    if (!escribirManifiesto(ruta, cantidad, 0)) {
+        printf("No pude escribir %s\n", ruta);
+        return 1;
+    }
+    
+    // 1) Uno por uno, como lo hace el menu (sin bitacora para no medir printf)
+    bitacoraActiva() = false;
+    ListaGestion* sistema = new ListaGestion();
+    char id[50];
+    long long inicio = relojNs();
+    for (int i = 0; i < cantidad; i++) {
+        snprintf(id, sizeof(id), "S-%07d", i);
+        if (i % 2 == 0) {
+            sistema->agregarSensor(new SensorTemperatura(id));
+        } else {
+            sistema->agregarSensor(new SensorPresion(id));
+        }
+    }
+    long long unoPorUnoNs = relojNs() - inicio;
+    delete sistema;
+    bitacoraActiva() = true;
+    printf("agregarSensor uno por uno: %.1f ms (%.0f ns por sensor)\n",
+           nsAMs(unoPorUnoNs), (double)unoPorUnoNs / cantidad);
+    
+    // 2) Manifiesto (la bitacora queda encendida: solo debe salir el resumen)
+    sistema = new ListaGestion();
+    inicio = relojNs();
+    int creados = sistema->cargarManifiesto(ruta);
+    long long cargaNs = relojNs() - inicio;
+    printf("cargarManifiesto: %.1f ms (%.0f ns por sensor), %.1fx\n",
+           nsAMs(cargaNs), (double)cargaNs / cantidad, (double)unoPorUnoNs / cargaNs);
+    int correctos = verificarManifiesto(sistema, cantidad, 0);
+    printf("Verificacion: %d creados, %d de %d encontrados -> %s\n", creados, correctos, cantidad,
+           creados == cantidad && correctos == cantidad ? "OK" : "DIFERENTE");
+    
+    // 3) Recarga con cambios
+    if (!escribirManifiesto(ruta, cantidad, cambio)) {
+        printf("No pude escribir %s\n", ruta);
+        delete sistema;
+        return 1;
+    }
+    inicio = relojNs();
+    creados = sistema->recargarManifiesto(ruta);
+    long long recargaNs = relojNs() - inicio;
+    int esperados = cantidad + (cantidad + cambio - 3) / cambio;  // Los S- (bien o ausentes) mas los N-
+    correctos = verificarManifiesto(sistema, cantidad, cambio);
+    int tamanioEsperado = cantidad - (cantidad + cambio - 1) / cambio + (cantidad + cambio - 3) / cambio;
+    printf("recargarManifiesto: %.1f ms, %d creados, %d sensores -> %s\n",
+           nsAMs(recargaNs), creados, sistema->obtenerTamanio(),
+           correctos == esperados && sistema->obtenerTamanio() == tamanioEsperado ? "OK" : "DIFERENTE");
+    
+    bitacoraActiva() = false;
+    inicio = relojNs();
+    delete sistema;
+    long long liberarNs = relojNs() - inicio;
+    bitacoraActiva() = true;
+    printf("Destruccion del registro: %.1f ms\n", nsAMs(liberarNs));
+    remove(ruta);
+    return 0;
+}
+
+/**
+ * @brief Como se arma el registro del benchmark de cierre
+ */
+enum ArmadoCierre {
+    ARMADO_SUELTOS,     // agregarSensor; historial y detector fuera de las arenas
+    ARMADO_ARENA,       // agregarSensor; historial y detector en la arena del registro
+    ARMADO_MANIFIESTO   // cargarManifiesto: sensores construidos en una arena
+};
+
+/**
+ * @brief Datos para llenar los sensores de un registro
+ */
+struct LlenadoCierre {
+    const double* lote;  // 4096 lecturas que se repiten
+    int lecturas;        // Lecturas por sensor
+    int numero;          // Sensores llenados hasta ahora
+};
+
+/**
+ * @brief Llena el historial de un sensor (uno de cada 100 con detector)
+ * @param sensor Sensor ya registrado
+ * @param contexto Apuntador a LlenadoCierre
+ */
+inline void llenarSensorCierre(SensorBase* sensor, void* contexto) {
+    LlenadoCierre* llenado = (LlenadoCierre*)contexto;
+    if (llenado->numero++ % 100 == 0) sensor->activarDeteccion();
+    for (int hechas = 0; hechas < llenado->lecturas; hechas += 4096) {
+        int n = llenado->lecturas - hechas < 4096 ? llenado->lecturas - hechas : 4096;
+        sensor->registrarLote(llenado->lote, n);
+    }
+}
+
+/**
+ * @brief Crea un registro con historiales llenos para medir el cierre
+ * @param sensores Cuantos sensores
+ * @param lecturas Lecturas por sensor
+ * @param tipos Codigos de tipo que se van rotando (ej. "TP")
+ * @param armado Como se crean los sensores
+ * @return La lista de gestion nueva, NULL si no se pudo escribir el manifiesto
+ */
+inline ListaGestion* llenarRegistro(int sensores, int lecturas, const char* tipos, ArmadoCierre armado) {
+    ListaGestion* sistema = new ListaGestion();
+    double lote[4096];
+    for (int j = 0; j < 4096; j++) lote[j] = 70 + j % 41;
+    LlenadoCierre llenado = { lote, lecturas, 0 };
+    int cuantosTipos = (int)strlen(tipos);
+    char id[50];
+    
+    if (armado == ARMADO_MANIFIESTO) {
+        const char* ruta = "/tmp/sensores_cierre.txt";
+        FILE* archivo = fopen(ruta, "w");
+        if (archivo == NULL) {
+            delete sistema;
+            return NULL;
+        }
+        for (int i = 0; i < sensores; i++) {
+            char tipo = tipos[i % cuantosTipos];
+            fprintf(archivo, "%c-%07d %c\n", tipo, i, tipo);
+        }
+        fclose(archivo);
+        sistema->cargarManifiesto(ruta);
+        remove(ruta);
+        sistema->paraCadaSensor(llenarSensorCierre, &llenado);
+        return sistema;
+    }
+    for (int i = 0; i < sensores; i++) {
+        const TipoSensor* tipo = RegistroTipos::buscar(tipos[i % cuantosTipos]);
+        snprintf(id, sizeof(id), "%c-%07d", tipo->codigo, i);
+        SensorBase* sensor = tipo->crear(id);
+        sistema->agregarSensor(sensor);
+        if (armado == ARMADO_SUELTOS) {
+            sensor->usarArenaHistorial(NULL);
+            sensor->usarArenaDetector(NULL);
+        }
+        llenarSensorCierre(sensor, &llenado);
+    }
+    return sistema;
+}
+
+/**
+ * @brief Mide cuanto tarda en cerrarse un registro grande con cada modo
+ * 
+ * Uso: --bench cierre [sensores] [lecturas_por_sensor] [tipos]
+ * Por defecto 10000 sensores con 10000 lecturas, alternando temperatura
+ * y presion (unos 430 MB de historial). Con tipos = V (muestras de 2
+ * bytes) 10000 x 100000 cabe en unos 2.2 GB. La salida rapida se mide en
+ * un proceso hijo con su propio registro, hasta que el sistema operativo
+ * termina de recuperar la memoria. Esa no se revisa contra el contador:
+ * no descuenta lo que abandona.
+ */
+inline int benchCierre(int argc, char** argv) {
+    int sensores = argumentoEntero(argc, argv, 0, 10000);
+    int lecturas = argumentoEntero(argc, argv, 1, 10000);
+    const char* tipos = argc > 2 ? argv[2] : "TP";
+    if (*tipos == '\0') return 1;
+    for (const char* t = tipos; *t != '\0'; t++) {
+        if (RegistroTipos::buscar(*t) == NULL) {
+            printf("Tipo desconocido: %c\n", *t);
+            return 1;
+        }
+    }
+    
+    printf("=== Benchmark: cierre del registro ===\n");
+    printf("%d sensores x %d lecturas (%.0f M lecturas), tipos %s, 1 de cada 100 con detector\n",
+           sensores, lecturas, (double)sensores * lecturas / 1e6, tipos);
+    bitacoraActiva() = false;
+    long long base = ContadorMemoria::bytesVivos();
+    
+    // 1) Como antes: bloques sueltos, liberados uno por uno
+    // 2) Bloques en la arena, devueltos uno por uno
+    // 3) Bloques en la arena, soltados por trozos (cada sensor suelto se destruye)
+    // 4) Sensores de manifiesto: solo se sueltan arenas y trozos
+    const int MODOS = 4;
+    const char* nombres[MODOS] = {
+        "Bloques sueltos, uno por uno", "Arena, detallado", "Arena, en bloque", "Manifiesto, en bloque"
+    };
+    const ArmadoCierre armados[MODOS] = { ARMADO_SUELTOS, ARMADO_ARENA, ARMADO_ARENA, ARMADO_MANIFIESTO };
+    const ModoCierre cierres[MODOS] = { CIERRE_DETALLADO, CIERRE_DETALLADO, CIERRE_EN_BLOQUE, CIERRE_EN_BLOQUE };
+    for (int modo = 0; modo < MODOS; modo++) {
+        ListaGestion* sistema = llenarRegistro(sensores, lecturas, tipos, armados[modo]);
+        if (sistema == NULL) {
+            printf("No pude escribir el manifiesto\n");
+            continue;
+        }
+        long long bytes = ContadorMemoria::bytesVivos() - base;
+        sistema->fijarModoCierre(cierres[modo]);
+        long long inicio = relojNs();
+        delete sistema;
+        long long cierreNs = relojNs() - inicio;
+        long long restantes = ContadorMemoria::bytesVivos() - base;
+        printf("%-30s %8.1f ms (%.0f MB), memoria que queda: %lld bytes -> %s\n", nombres[modo],
+               nsAMs(cierreNs), bytes / 1048576.0, restantes, restantes == 0 ? "OK" : "FUGA");
+    }
+    
+    // 5) Salida rapida: un hijo llena su propio registro, no libera nada y
+    //    termina; cuento hasta que el sistema operativo recupero su memoria
+    int aviso[2];
+    if (pipe(aviso) == 0) {
+        fflush(stdout);
+        pid_t hijo = fork();
+        if (hijo == 0) {
+            ListaGestion* sistema = llenarRegistro(sensores, lecturas, tipos, ARMADO_MANIFIESTO);
+            if (sistema == NULL) _exit(1);
+            sistema->fijarModoCierre(CIERRE_SALIDA);
+            long long inicio = relojNs();
+            if (write(aviso[1], &inicio, sizeof(inicio)) != (ssize_t)sizeof(inicio)) _exit(1);
+            delete sistema;
+            _exit(0);
+        }
+        close(aviso[1]);
+        long long inicio = 0;
+        bool leido = hijo > 0 && read(aviso[0], &inicio, sizeof(inicio)) == (ssize_t)sizeof(inicio);
+        if (hijo > 0) waitpid(hijo, NULL, 0);
+        if (leido) {
+            printf("%-30s %8.1f ms (destructor y fin del proceso)\n", "Salida rapida",
+                   nsAMs(relojNs() - inicio));
+        }
+        close(aviso[0]);
+    }
+    bitacoraActiva() = true;
+    return 0;
+}
+
+/**
+ * @brief RMS y pico de referencia, un ciclo simple sin vectores explicitos
+ * @param x Muestras
+ * @param n Cuantas
+ * @param energia Donde acumulo
+ */
+inline void energiaSimple(const short* x, int n, EnergiaVibracion& energia) {
+    for (int i = 0; i < n; i++) {
+        int v = x[i];
+        energia.sumaCuadrados += (long long)(v * v);
+        if (v > energia.maximo) energia.maximo = v;
+        if (v < energia.minimo) energia.minimo = v;
+    }
+    energia.muestras += n;
+}
+
+/**
+ * @brief Crea un sensor del tipo que toca en una flota con todos los tipos
+ * @param i Numero del sensor (el tipo rota en orden del registro)
+ * @return Sensor nuevo
+ */
+inline SensorBase* crearSensorRotando(int i) {
+    const TipoSensor& tipo = RegistroTipos::enPosicion(i % RegistroTipos::cantidad());
+    char id[50];
+    snprintf(id, sizeof(id), "%c-%07d", tipo.codigo, i);
+    return tipo.crear(id);
+}
+
+/**
+ * @brief Mide los tipos nuevos: nucleo de vibracion, 10 kHz sostenidos y flota mixta
+ * 
+ * Uso: --bench tipos [sensores_vibracion] [segundos] [flota_mixta]
+ * Por defecto 1000 acelerometros a 10 kHz durante 2 s simulados, en
+ * rafagas de 100 ms, y una flota mixta de 100000 sensores de todos los
+ * tipos registrados alimentada con el simulador de cada tipo.
+ */
+inline int benchTipos(int argc, char** argv) {
+    int vibracion = argumentoEntero(argc, argv, 0, 1000);
+    int segundos = argumentoEntero(argc, argv, 1, 2);
+    int flota = argumentoEntero(argc, argv, 2, 100000);
+    const int MUESTREO = 10000;          // 10 kHz
+    const int RAFAGA = MUESTREO / 10;    // 100 ms por rafaga
+    
+    printf("=== Benchmark: tipos de sensor ===\n");
+    RegistroTipos::imprimir();
+    bitacoraActiva() = false;
+    
+    // 1) Nucleo RMS/pico con vectores contra un ciclo simple
+    const int MUESTRAS = 1 << 20;
+    short* senal = (short*)malloc(sizeof(short) * MUESTRAS);
+    unsigned semilla = 7;
+    SimuladorArduino::generarRafagaVibracion(senal, MUESTRAS, 0, MUESTREO, 120.0, 8000.0, semilla);
+    EnergiaVibracion simple;
+    EnergiaVibracion vectores;
+    const int REPETICIONES = 20;
+    long long inicio = relojNs();
+    for (int r = 0; r < REPETICIONES; r++) energiaSimple(senal, MUESTRAS, simple);
+    long long simpleNs = relojNs() - inicio;
+    inicio = relojNs();
+    for (int r = 0; r < REPETICIONES; r++) vectores.acumular(senal, MUESTRAS);
+    long long vectoresNs = relojNs() - inicio;
+    bool iguales = simple.sumaCuadrados == vectores.sumaCuadrados && simple.pico() == vectores.pico();
+    double totalMuestras = (double)MUESTRAS * REPETICIONES;
+    printf("\nNucleo RMS/pico sobre %d muestras x %d:\n", MUESTRAS, REPETICIONES);
+    printf("  Ciclo simple: %.2f ns por muestra (%.0f M muestras/s)\n",
+           simpleNs / totalMuestras, totalMuestras / (simpleNs / 1e3));
+    printf("  Vectores:     %.2f ns por muestra (%.0f M muestras/s), RMS %.1f, pico %d -> %s\n",
+           vectoresNs / totalMuestras, totalMuestras / (vectoresNs / 1e3),
+           vectores.rms(), vectores.pico(), iguales ? "OK" : "DIFERENTE");
+    
+    // 2) Acelerometros a 10 kHz: rafagas de 100 ms y un procesarTodos por rafaga
+    ListaGestion* sistema = new ListaGestion();
+    sistema->reservarIndice(vibracion);
+    SensorVibracion** acelerometros = (SensorVibracion**)malloc(sizeof(SensorVibracion*) * vibracion);
+    char id[50];
+    for (int s = 0; s < vibracion; s++) {
+        snprintf(id, sizeof(id), "V-%05d", s);
+        acelerometros[s] = new SensorVibracion(id);
+        sistema->agregarSensor(acelerometros[s]);
+    }
+    int rafagas = segundos * 10;
+    long long ingestaNs = 0;
+    long long procesoNs = 0;
+    for (int r = 0; r < rafagas; r++) {
+        // Cada rafaga sale de la senal ya generada (no mido el generador)
+        long long desde = relojNs();
+        for (int s = 0; s < vibracion; s++) {
+            int desplazamiento = (int)(((long long)s * 7919 + (long long)r * RAFAGA) % (MUESTRAS - RAFAGA));
+            acelerometros[s]->registrarMuestras(senal + desplazamiento, RAFAGA);
+        }
+        long long medio = relojNs();
+        sistema->procesarTodos();
+        procesoNs += relojNs() - medio;
+        ingestaNs += medio - desde;
+    }
+    double muestras = (double)vibracion * rafagas * RAFAGA;
+    double realNs = segundos * 1e9;
+    printf("\n%d acelerometros a %d Hz durante %d s simulados (%.0f M muestras):\n",
+           vibracion, MUESTREO, segundos, muestras / 1e6);
+    printf("  Ingesta: %.1f ms (%.1f ns por muestra), procesamiento: %.1f ms\n",
+           nsAMs(ingestaNs), ingestaNs / muestras, nsAMs(procesoNs));
+    printf("  Uso de un nucleo: %.2f%% del tiempo real, cabrian %.0f acelerometros por nucleo\n",
+           100.0 * (ingestaNs + procesoNs) / realNs,
+           vibracion * realNs / (double)(ingestaNs + procesoNs));
+    printf("  Ultimo RMS de %s: %.1f, pico %d\n", acelerometros[0]->obtenerNombre(),
+           acelerometros[0]->obtenerUltimoRms(), acelerometros[0]->obtenerUltimoPico());
+    free(acelerometros);
+    delete sistema;
+    free(senal);
+    
+    // 3) Flota mixta: lecturas simuladas de cada tipo y procesarTodos por polimorfismo
+    ListaGestion* mezcla = new ListaGestion();
+    mezcla->reservarIndice(flota);
+    for (int i = 0; i < flota; i++) mezcla->agregarSensor(crearSensorRotando(i));
+    const int PASADAS = 5;
+    const int LECTURAS = 4;  // Lecturas (o tramas) por sensor y pasada
+    double lote[LECTURAS * TipoSensor::MAXIMO_CANALES];
+    long long esperados = 0;  // Valores registrados
+    long long mezclaIngestaNs = 0;
+    long long mezclaProcesoNs = 0;
+    semilla = 11;
+    for (int p = 0; p < PASADAS; p++) {
+        inicio = relojNs();
+        for (int i = 0; i < flota; i++) {
+            const TipoSensor& tipo = RegistroTipos::enPosicion(i % RegistroTipos::cantidad());
+            for (int k = 0; k < LECTURAS; k++) tipo.simular(semilla, lote + k * tipo.canales);
+            snprintf(id, sizeof(id), "%c-%07d", tipo.codigo, i);
+            mezcla->buscarSensor(id)->registrarLote(lote, LECTURAS * tipo.canales);
+            esperados += LECTURAS * tipo.canales;
+        }
+        long long medio = relojNs();
+        mezcla->procesarTodos();
+        mezclaProcesoNs += relojNs() - medio;
+        mezclaIngestaNs += medio - inicio;
+    }
+    long long guardados = 0;
+    for (int i = 0; i < flota; i++) {
+        snprintf(id, sizeof(id), "%c-%07d", RegistroTipos::enPosicion(i % RegistroTipos::cantidad()).codigo, i);
+        guardados += mezcla->buscarSensor(id)->obtenerCantidadLecturas();
+    }
+    double visitas = (double)flota * PASADAS;
+    printf("\nFlota mixta de %d sensores (%d tipos) x %d pasadas de %d lecturas:\n",
+           flota, RegistroTipos::cantidad(), PASADAS, LECTURAS);
+    printf("  Simular, buscar y registrar: %.1f ns por sensor\n", mezclaIngestaNs / visitas);
+    printf("  procesarTodos:               %.1f ns por sensor\n", mezclaProcesoNs / visitas);
+    printf("  Valores en los historiales: %lld de %lld registrados (temperatura quita su minimo al procesar)\n",
+           guardados, esperados);
+    delete mezcla;
+    bitacoraActiva() = true;
+    return 0;
+}
+
+/**
+ * @brief Imprime un renglon de la reproduccion diferencial
+ * @param nombre Implementacion
+ * @param ns Tiempo de la reproduccion
+ * @param referenciaNs Tiempo de la referencia
+ * @param pasos Operaciones reproducidas
+ * @param diferencias Pasos e historiales distintos de la referencia
+ */
+inline void imprimirReproduccion(const char* nombre, long long ns, long long referenciaNs,
+                                 int pasos, int diferencias) {
+    printf("  %-28s %9.1f %10.2f %9.2fx   %s\n", nombre, nsAMs(ns), pasos / (ns / 1e3),
+           (double)referenciaNs / ns, diferencias == 0 ? "iguales" : "DIFERENTES");
+}
+
+/**
+ * @brief Reproduce un flujo de historiales en la lista de referencia y en las de bloques
+ * @tparam T Tipo de las lecturas
+ * @param etiqueta Nombre del tipo para el reporte
+ * @param flujo Flujo grabado
+ * @param tolerancia Error relativo permitido en promedios
+ * @return Diferencias encontradas
+ */
+template <typename T>
+int reproducirHistoriales(const char* etiqueta, const FlujoOperaciones& flujo, double tolerancia) {
+    int n = flujo.obtenerDestinos();
+    int pasos = flujo.obtenerCantidad();
+    double* esperados = (double*)malloc(sizeof(double) * pasos);
+    double* obtenidos = (double*)malloc(sizeof(double) * pasos);
+    ListaSensor<T, false>* referencia = new ListaSensor<T, false>[n];
+    ListaSensor<T, true>* bloques = new ListaSensor<T, true>[n];
+    ListaSensor<T, true>* conArena = new ListaSensor<T, true>[n];
+    ArenaBloques arena(sizeof(BloqueLecturas<T>));
+    for (int i = 0; i < n; i++) conArena[i].usarArena(&arena);
+    
+    long long inicio = relojNs();
+    reproducirListas(flujo, referencia, esperados);
+    long long referenciaNs = relojNs() - inicio;
+    HistorialesDeListas<T, false> deReferencia = { referencia };
+    
+    char nombre[64];
+    printf("\nHistoriales de %s (%d listas):\n", etiqueta, n);
+    printf("  %-28s %9s %10s %10s   %s\n", "Implementacion", "ms", "M ops/s", "velocidad", "resultado");
+    snprintf(nombre, sizeof(nombre), "ListaSensor<%s, false>", etiqueta);
+    imprimirReproduccion(nombre, referenciaNs, referenciaNs, pasos, 0);
+    
+    int total = 0;
+    for (int variante = 0; variante < 2; variante++) {
+        ListaSensor<T, true>* listas = variante == 0 ? bloques : conArena;
+        snprintf(nombre, sizeof(nombre), "bloques%s", variante == 0 ? " sueltos" : " en arena");
+        inicio = relojNs();
+        reproducirListas(flujo, listas, obtenidos);
+        long long ns = relojNs() - inicio;
+        HistorialesDeListas<T, true> deListas = { listas };
+        int diferencias = contarDiferencias(nombre, flujo, esperados, obtenidos, tolerancia) +
+                          compararContenidos(nombre, n, deReferencia, deListas);
+        imprimirReproduccion(nombre, ns, referenciaNs, pasos, diferencias);
+        total += diferencias;
+    }
+    
+    delete[] referencia;
+    delete[] bloques;
+    delete[] conArena;
+    free(esperados);
+    free(obtenidos);
+    return total;
+}
+
+/**
+ * @brief Reproduce un flujo de registro en un registro ya poblado y lo compara con la referencia
+ * @tparam Registro ListaGestion o ListaGestionFragmentada
+ * @param nombre Implementacion para el reporte
+ * @param flujo Flujo de registro
+ * @param registro Registro poblado con poblarRegistro
+ * @param esperados Resultados de la referencia
+ * @param deReferencia Historiales de la referencia
+ * @param referenciaNs Tiempo de la referencia
+ * @param tolerancia Error relativo permitido en promedios
+ * @return Diferencias encontradas
+ */
+template <class Registro>
+int compararRegistro(const char* nombre, const FlujoOperaciones& flujo, Registro& registro,
+                     const double* esperados, const HistorialesDeRegistro<RegistroReferencia>& deReferencia,
+                     long long referenciaNs, double tolerancia) {
+    int pasos = flujo.obtenerCantidad();
+    double* obtenidos = (double*)malloc(sizeof(double) * pasos);
+    long long inicio = relojNs();
+    reproducirRegistro(flujo, registro, obtenidos);
+    long long ns = relojNs() - inicio;
+    HistorialesDeRegistro<Registro> deRegistro = { &registro, &flujo };
+    int diferencias = contarDiferencias(nombre, flujo, esperados, obtenidos, tolerancia) +
+                      compararContenidos(nombre, flujo.obtenerDestinos(), deReferencia, deRegistro);
+    imprimirReproduccion(nombre, ns, referenciaNs, pasos, diferencias);
+    free(obtenidos);
+    return diferencias;
+}
+
+/**
+ * @brief Reproduccion diferencial: mismas operaciones en la referencia y en cada optimizacion
+ * 
+ * Uso: --bench diferencial [semilla] [operaciones] [listas] [sensores]
+ * Por defecto semilla 1, 200000 operaciones sobre 64 historiales y sobre
+ * un registro de 2000 sensores de todos los tipos registrados.
+ * 
+ * Graba un flujo de operaciones con la semilla y lo reproduce:
+ *  - Historiales (float e int): la lista enlazada de un nodo por dato
+ *    (ListaSensor<T, false>) es la referencia; se compara contra la de
+ *    bloques, con bloques sueltos y con bloques de una arena.
+ *  - Registro: un arreglo con busqueda lineal que revisa a todos en
+ *    procesarTodos es la referencia; se compara contra ListaGestion
+ *    (indice hash y cola de sucios) y ListaGestionFragmentada (un hilo
+ *    por fragmento).
+ * Cada paso deja un resultado (tamanio, encontrado, minimo, promedio,
+ * procesados) y al final se comparan los historiales completos. Los
+ * promedios se comparan con tolerancia relativa de 1e-9.
+ * 
+ * @return 0 si todo coincide, 1 si hubo diferencias (con la semilla para repetirlas)
+ */
+inline int benchDiferencial(int argc, char** argv) {
+    unsigned semilla = (unsigned)argumentoEntero(argc, argv, 0, 1);
+    int operaciones = argumentoEntero(argc, argv, 1, 200000);
+    int listas = argumentoEntero(argc, argv, 2, 64);
+    int sensores = argumentoEntero(argc, argv, 3, 2000);
+    const double TOLERANCIA = 1e-9;
+    
+    printf("=== Benchmark: reproduccion diferencial ===\n");
+    bitacoraActiva() = false;
+    Metricas::activas() = false;
+    
+    FlujoOperaciones historiales(semilla, operaciones, listas, false);
+    printf("Flujo de historiales (semilla %u): %d insertar, %d lotes, %d buscar, %d eliminarMasBajo, %d promedio\n",
+           historiales.obtenerSemilla(), historiales.contar(PASO_INSERTAR), historiales.contar(PASO_INSERTAR_LOTE),
+           historiales.contar(PASO_BUSCAR), historiales.contar(PASO_ELIMINAR_MINIMO),
+           historiales.contar(PASO_PROMEDIO));
+    int diferencias = reproducirHistoriales<float>("float", historiales, TOLERANCIA);
+    diferencias += reproducirHistoriales<int>("int", historiales, TOLERANCIA);
+    
+    FlujoOperaciones registro(semilla, operaciones, sensores, true);
+    printf("\nFlujo de registro (semilla %u): %d lotes, %d buscar, %d procesarTodos sobre %d sensores\n",
+           registro.obtenerSemilla(), registro.contar(PASO_INSERTAR_LOTE), registro.contar(PASO_BUSCAR),
+           registro.contar(PASO_PROCESAR_TODOS), registro.obtenerDestinos());
+    int pasos = registro.obtenerCantidad();
+    double* esperados = (double*)malloc(sizeof(double) * pasos);
+    RegistroReferencia* referencia = new RegistroReferencia(sensores);
+    poblarRegistro(registro, *referencia);
+    long long inicio = relojNs();
+    reproducirRegistro(registro, *referencia, esperados);
+    long long referenciaNs = relojNs() - inicio;
+    HistorialesDeRegistro<RegistroReferencia> deReferencia = { referencia, &registro };
+    printf("  %-28s %9s %10s %10s   %s\n", "Implementacion", "ms", "M ops/s", "velocidad", "resultado");
+    imprimirReproduccion("referencia (busqueda lineal)", referenciaNs, referenciaNs, pasos, 0);
+    
+    ListaGestion* gestion = new ListaGestion();
+    poblarRegistro(registro, *gestion);
+    diferencias += compararRegistro("ListaGestion", registro, *gestion, esperados, deReferencia,
+                                    referenciaNs, TOLERANCIA);
+    delete gestion;
+    
+    ListaGestionFragmentada* fragmentada = new ListaGestionFragmentada(8, false);
+    poblarRegistro(registro, *fragmentada);
+    diferencias += compararRegistro("ListaGestionFragmentada x8", registro, *fragmentada, esperados,
+                                    deReferencia, referenciaNs, TOLERANCIA);
+    delete fragmentada;
+    
+    delete referencia;
+    free(esperados);
+    Metricas::activas() = true;
+    bitacoraActiva() = true;
+    
+    if (diferencias == 0) {
+        printf("\nSin diferencias contra la referencia.\n");
+        return 0;
+    }
+    printf("\n%d diferencias; se repiten con --bench diferencial %u %d %d %d\n",
+           diferencias, semilla, operaciones, listas, sensores);
+    return 1;
+}
+
+#if PLANIFICADOR_DISPONIBLE
+#include <climits>          // Para PIPE_BUF
+#include <sys/resource.h>  // Para subir el limite de descriptores
+
+/**
+ * @brief Datos del hilo que hace de dispositivos escribiendo en los pipes
+ */
+struct ArgsEscritor {
+    int* fds;              // Lado de escritura de cada pipe
+    int dispositivos;      // Cuantos pipes
+    int rafagasPorDispositivo;
+    const char* rafagaT;   // Texto de una rafaga de temperatura
+    int largoT;
+    const char* rafagaP;   // Texto de una rafaga de presion
+    int largoP;
+};
+
+/**
+ * @brief Escribe rafagas por turnos en todos los pipes y los cierra al final
+ * @param arg Apuntador a ArgsEscritor
+ * @return Siempre NULL
+ */
+inline void* hiloEscritor(void* arg) {
+    ArgsEscritor* a = (ArgsEscritor*)arg;
+    for (int r = 0; r < a->rafagasPorDispositivo; r++) {
+        for (int d = 0; d < a->dispositivos; d++) {
+            // Cada rafaga cabe en PIPE_BUF, asi que llega entera
+            const char* texto = d % 2 == 0 ? a->rafagaT : a->rafagaP;
+            int largo = d % 2 == 0 ? a->largoT : a->largoP;
+            if (write(a->fds[d], texto, largo) != largo) {
+                printf("[Benchmark] Escritura incompleta en el dispositivo %d\n", d);
+            }
+        }
+    }
+    for (int d = 0; d < a->dispositivos; d++) close(a->fds[d]);
+    return NULL;
+}
+
+/**
+ * @brief Arma una rafaga de lineas como las que manda el Arduino
+ * @param destino Donde escribo el texto
+ * @param espacio Bytes disponibles
+ * @param lineas Cuantas lecturas
+ * @param tipo 'T' o 'P'
+ * @return Largo del texto
+ */
+inline int armarRafaga(char* destino, int espacio, int lineas, char tipo) {
+    int largo = 0;
+    for (int i = 0; i < lineas && largo < espacio; i++) {
+        if (tipo == 'T') {
+            largo += snprintf(destino + largo, espacio - largo, "%.2f\n", 15.0 + (i * 37 % 300) / 10.0);
+        } else {
+            largo += snprintf(destino + largo, espacio - largo, "%d\n", 70 + i * 7 % 41);
+        }
+    }
+    return largo < espacio ? largo : espacio;
+}
+
+/**
+ * @brief Crea un sistema con sensores alternando temperatura y presion
+ * @param cantidad Cuantos sensores
+ * @return La lista de gestion nueva
+ */
+inline ListaGestion* crearSistemaDispositivos(int cantidad) {
+    ListaGestion* sistema = new ListaGestion();
+    sistema->reservarIndice(cantidad);
+    char id[50];
+    for (int i = 0; i < cantidad; i++) {
+        if (i % 2 == 0) {
+            snprintf(id, sizeof(id), "T-%05d", i);
+            sistema->agregarSensor(new SensorTemperatura(id));
+        } else {
+            snprintf(id, sizeof(id), "P-%05d", i);
+            sistema->agregarSensor(new SensorPresion(id));
+        }
+    }
+    return sistema;
+}
+
+/**
+ * @brief Mide el planificador de corrutinas con muchos dispositivos en pipes
+ * 
+ * Uso: --bench dispositivos [dispositivos] [lecturas_por_dispositivo] [hilos] [lineas_por_rafaga]
+ * Un hilo escribe rafagas de texto en un pipe por dispositivo y el
+ * planificador las lee con epoll, convierte y entrega a cada sensor.
+ * El sobrecosto por lectura es el CPU de los trabajadores menos lo que
+ * cuesta registrar las mismas lecturas directo desde memoria. Al final
+ * mide los despertadores con dispositivos de sondeo por tiempo.
+ */
+inline int benchDispositivos(int argc, char** argv) {
+    int dispositivos = argumentoEntero(argc, argv, 0, 2000);
+    int lecturasPorDispositivo = argumentoEntero(argc, argv, 1, 4000);
+    int hilos = argumentoEntero(argc, argv, 2, 2);
+    int lineas = argumentoEntero(argc, argv, 3, 8);
+    if (lineas > 64) lineas = 64;  // Una rafaga debe caber en PIPE_BUF
+    int rafagas = (lecturasPorDispositivo + lineas - 1) / lineas;
+    long long total = (long long)rafagas * lineas * dispositivos;
+    
+    // Dos descriptores por dispositivo mas los del epoll de cada hilo
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+    
+    char rafagaT[PIPE_BUF];
+    char rafagaP[PIPE_BUF];
+    int largoT = armarRafaga(rafagaT, sizeof(rafagaT), lineas, 'T');
+    int largoP = armarRafaga(rafagaP, sizeof(rafagaP), lineas, 'P');
+    
+    bitacoraActiva() = false;
+    printf("=== Benchmark: planificador de dispositivos ===\n");
+    printf("%d dispositivos en pipes, %d rafagas de %d lineas cada uno, %d hilos\n",
+           dispositivos, rafagas, lineas, hilos);
+    
+    // 1) Referencia: las mismas lecturas registradas directo, sin pipes ni corrutinas
+    ListaGestion* sistema = crearSistemaDispositivos(dispositivos);
+    SensorBase** sensores = (SensorBase**)malloc(sizeof(SensorBase*) * dispositivos);
+    char id[50];
+    for (int d = 0; d < dispositivos; d++) {
+        snprintf(id, sizeof(id), d % 2 == 0 ? "T-%05d" : "P-%05d", d);
+        sensores[d] = sistema->buscarSensor(id);
+    }
+    double valores[64];
+    for (int i = 0; i < lineas; i++) valores[i] = 15.0 + (i * 37 % 300) / 10.0;
+    long long inicio = relojNs();
+    for (int r = 0; r < rafagas; r++) {
+        for (int d = 0; d < dispositivos; d++) sensores[d]->registrarLote(valores, lineas);
+    }
+    long long directoNs = relojNs() - inicio;
+    free(sensores);
+    delete sistema;
+    printf("Registro directo:   %.1f ms, %.1f ns por lectura\n",
+           nsAMs(directoNs), (double)directoNs / total);
+    
+    // 2) Lo mismo llegando por pipes al planificador
+    sistema = crearSistemaDispositivos(dispositivos);
+    int* escritura = (int*)malloc(sizeof(int) * dispositivos);
+    int creados = 0;
+    {
+        PlanificadorDispositivos planificador(*sistema, hilos);
+        for (int d = 0; d < dispositivos; d++) {
+            int extremos[2];
+            if (pipe(extremos) != 0) {
+                printf("No se pudo crear el pipe %d (limite de descriptores?)\n", d);
+                break;
+            }
+            snprintf(id, sizeof(id), d % 2 == 0 ? "T-%05d" : "P-%05d", d);
+            planificador.agregarDispositivoFd(id, extremos[0]);
+            escritura[d] = extremos[1];
+            creados++;
+        }
+        total = (long long)rafagas * lineas * creados;
+        
+        ArgsEscritor args = { escritura, creados, rafagas, rafagaT, largoT, rafagaP, largoP };
+        pthread_t escritor;
+        inicio = relojNs();
+        pthread_create(&escritor, NULL, hiloEscritor, &args);
+        planificador.correr();
+        pthread_join(escritor, NULL);
+        long long paredNs = relojNs() - inicio;
+        
+        long long cpuNs = planificador.obtenerCpuNs();
+        long long entregadas = planificador.obtenerLecturas();
+        long long despertares = planificador.obtenerDespertares();
+        printf("Planificador:       %.1f ms de pared, %.1f ms de CPU en los trabajadores\n",
+               nsAMs(paredNs), nsAMs(cpuNs));
+        printf("Lecturas entregadas: %lld de %lld, %.1f lecturas por despertar\n",
+               entregadas, total, despertares == 0 ? 0.0 : (double)entregadas / despertares);
+        printf("CPU por lectura: %.1f ns, sobrecosto sobre el registro directo: %.1f ns\n",
+               entregadas == 0 ? 0.0 : (double)cpuNs / entregadas,
+               entregadas == 0 ? 0.0 : (double)(cpuNs - directoNs) / entregadas);
+        planificador.imprimirReporte();
+    }
+    free(escritura);
+    delete sistema;
+    
+    // 3) Solo despertadores: dispositivos que se sondean cada milisegundo
+    int sondeados = dispositivos;
+    int lecturasSondeo = 100;
+    sistema = crearSistemaDispositivos(sondeados);
+    {
+        PlanificadorDispositivos planificador(*sistema, hilos);
+        for (int d = 0; d < sondeados; d++) {
+            snprintf(id, sizeof(id), d % 2 == 0 ? "T-%05d" : "P-%05d", d);
+            planificador.agregarDispositivoSondeo(id, 1000000LL, lecturasSondeo);
+        }
+        inicio = relojNs();
+        planificador.correr();
+        long long paredNs = relojNs() - inicio;
+        long long despertares = planificador.obtenerDespertares();
+        printf("Sondeo: %d dispositivos x %d lecturas cada 1 ms en %.1f ms, %.0f ns de CPU por despertar\n",
+               sondeados, lecturasSondeo, nsAMs(paredNs),
+               despertares == 0 ? 0.0 : (double)planificador.obtenerCpuNs() / despertares);
+        planificador.imprimirReporte();
+    }
+    delete sistema;
+    bitacoraActiva() = true;
+    return 0;
+}
+#endif // PLANIFICADOR_DISPONIBLE
+
+/**
+ * @brief Entrada de la tabla de benchmarks disponibles
+ */
+struct EntradaBenchmark {
+    const char* nombre;                // Nombre que se pasa despues de --bench
+    const char* descripcion;           // Texto corto para la ayuda
+    int (*funcion)(int, char**);       // Funcion que corre el benchmark
+};
+
+/**
+ * @brief Busca y ejecuta un benchmark por nombre
+ * @param argc Cantidad de argumentos despues de --bench
+ * @param argv Argumentos: nombre del benchmark y sus parametros
+ * @return Codigo de salida del programa
+ */
+inline int ejecutarBenchmark(int argc, char** argv) {
+    static const EntradaBenchmark tabla[] = {
+        { "perezoso", "procesarTodos con 1% de sensores activos", benchProcesamientoPerezoso },
+        { "pipeline", "ingesta directa contra pipeline asincrono", benchPipeline },
+        { "metricas", "sobrecosto de la instrumentacion", benchMetricas },
+        { "exportar", "exportar/importar historiales por columnas", benchExportar },
+        { "plantillas", "ListaSensor generica contra la de bloques", benchPlantillas },
+        { "fragmentos", "registro fragmentado de 1 a 32 hilos", benchFragmentos },
+        { "anomalias", "deteccion de anomalias con picos inyectados", benchAnomalias },
+        { "manifiesto", "carga y recarga masiva de sensores", benchManifiesto },
+        { "cierre", "destruccion del registro con cada modo de cierre", benchCierre },
+        { "tipos", "vibracion a 10 kHz y flota con todos los tipos registrados", benchTipos },
+        { "diferencial", "mismas operaciones en la referencia y en cada optimizacion", benchDiferencial },
+#if PLANIFICADOR_DISPONIBLE
+        { "dispositivos", "dispositivos en pipes con corrutinas y epoll", benchDispositivos },
+#endif
+    };
+    const int total = sizeof(tabla) / sizeof(tabla[0]);
+    
+    if (argc >= 1) {
+        for (int i = 0; i < total; i++) {
+            if (strcmp(argv[0], tabla[i].nombre) == 0) {
+                return tabla[i].funcion(argc - 1, argv + 1);
+            }
+        }
+    }
+    
+    printf("Benchmarks disponibles:\n");
+    for (int i = 0; i < total; i++) {
+        printf("  --bench %-12s %s\n", tabla[i].nombre, tabla[i].descripcion);
+    }
+    return 1;
+}
+
+#endif // BENCHMARKS_H
\ No newline at end of file
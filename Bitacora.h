@@ -0,0 +1,59 @@
+#ifndef BITACORA_H
+#define BITACORA_H
+
+#include <cstdio>  // Para printf (C puro, sin STL)
+
+/**
+ * @brief Interruptor global de los mensajes de bitacora del sistema
+ * 
+ * Los mensajes de registro ([Log], [Sistema], etc) son utiles en el menu
+ * interactivo, pero cuando manejo miles de sensores el printf por cada
+ * lectura se come todo el tiempo. Con esto los puedo apagar.
+ * 
+ * @return Referencia a la bandera (true = imprimir mensajes)
+ */
+inline bool& bitacoraActiva() {
+    static bool activa = true;  // Por defecto el programa es "platicador"
+    return activa;
+}
+
+/**
+ * @brief Cuantos SilencioBitacora hay abiertos en el hilo actual
+ * @return Referencia al contador del hilo (0 = sin silencio)
+ */
+inline int& bitacoraSilenciada() {
+    static thread_local int nivel = 0;
+    return nivel;
+}
+
+/**
+ * @brief Calla la bitacora en el hilo actual mientras vive el objeto
+ * 
+ * Para operaciones en lote que no deben imprimir un renglon por sensor.
+ * A diferencia de apagar bitacoraActiva(), no calla a los demas hilos
+ * (fragmentos, planificador) y se deshace solo en cualquier salida.
+ * Se puede anidar.
+ */
+class SilencioBitacora {
+public:
+    SilencioBitacora() {
+        bitacoraSilenciada()++;
+    }
+    
+    ~SilencioBitacora() {
+        bitacoraSilenciada()--;
+    }
+
+private:
+    SilencioBitacora(const SilencioBitacora&);
+    SilencioBitacora& operator=(const SilencioBitacora&);
+};
+
+/**
+ * @brief Imprime un mensaje de bitacora solo si la bitacora esta activa
+ * y el hilo actual no la silencio
+ */
+#define BITACORA(...) \
+    do { if (bitacoraActiva() && bitacoraSilenciada() == 0) printf(__VA_ARGS__); } while (0)
+
+#endif // BITACORA_H
\ No newline at end of file
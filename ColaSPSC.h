@@ -0,0 +1,95 @@
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <cstdlib>  // Para malloc, free (C puro, sin STL)
+
+/**
+ * @brief Cola circular sin candados para un productor y un consumidor
+ * 
+ * El productor solo escribe "fin" y el consumidor solo escribe "inicio",
+ * asi que basta con cargas/guardados atomicos (acquire/release) para que
+ * cada lado vea los datos del otro. La capacidad se redondea a potencia
+ * de dos para calcular la posicion con una mascara.
+ * 
+ * @tparam T Tipo de elemento; debe ser un struct simple porque el arreglo
+ *           se reserva con malloc y no corre constructores
+ */
+template <typename T>
+class ColaSPSC {
+private:
+    T* datos;            // Arreglo circular
+    unsigned mascara;    // capacidad - 1
+    
+    // Separo los indices en lineas de cache distintas para que el
+    // productor y el consumidor no se estorben entre si
+    char relleno0[64];
+    unsigned fin;        // Siguiente posicion a escribir (solo la toca el productor)
+    char relleno1[64];
+    unsigned inicio;     // Siguiente posicion a leer (solo la toca el consumidor)
+    char relleno2[64];
+    
+    // No se copia: la cola es duenia de su arreglo
+    ColaSPSC(const ColaSPSC&);
+    ColaSPSC& operator=(const ColaSPSC&);
+
+public:
+    /**
+     * @brief Constructor que reserva la cola
+     * @param capacidadMinima Cuantos elementos debe aguantar como minimo
+     */
+    ColaSPSC(unsigned capacidadMinima) : fin(0), inicio(0) {
+        unsigned capacidad = 2;
+        while (capacidad < capacidadMinima) capacidad <<= 1;
+        datos = (T*)malloc(sizeof(T) * capacidad);
+        mascara = capacidad - 1;
+    }
+    
+    /**
+     * @brief Destructor que libera el arreglo
+     */
+    ~ColaSPSC() {
+        free(datos);
+    }
+    
+    /**
+     * @brief Intenta meter un elemento (solo desde el hilo productor)
+     * @param elemento Elemento a copiar en la cola
+     * @return false si la cola esta llena
+     */
+    bool intentarEncolar(const T& elemento) {
+        unsigned miFin = fin;
+        unsigned suInicio = __atomic_load_n(&inicio, __ATOMIC_ACQUIRE);
+        if (miFin - suInicio > mascara) return false;  // Llena
+        datos[miFin & mascara] = elemento;
+        __atomic_store_n(&fin, miFin + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    
+    /**
+     * @brief Saca hasta "maximo" elementos de una vez (solo desde el consumidor)
+     * @param destino Arreglo donde copio los elementos
+     * @param maximo Espacio disponible en destino
+     * @return Cuantos elementos saque
+     */
+    int extraerVarios(T* destino, int maximo) {
+        unsigned miInicio = inicio;
+        unsigned suFin = __atomic_load_n(&fin, __ATOMIC_ACQUIRE);
+        unsigned disponibles = suFin - miInicio;
+        if (disponibles > (unsigned)maximo) disponibles = maximo;
+        for (unsigned i = 0; i < disponibles; i++) {
+            destino[i] = datos[(miInicio + i) & mascara];
+        }
+        __atomic_store_n(&inicio, miInicio + disponibles, __ATOMIC_RELEASE);
+        return (int)disponibles;
+    }
+    
+    /**
+     * @brief Cantidad aproximada de elementos en la cola
+     * @return Elementos pendientes (puede cambiar en cuanto lo leo)
+     */
+    unsigned tamanioAproximado() const {
+        return __atomic_load_n(&fin, __ATOMIC_ACQUIRE) - __atomic_load_n(&inicio, __ATOMIC_ACQUIRE);
+    }
+};
+
+#endif // COLA_SPSC_H
\ No newline at end of file
@@ -0,0 +1,325 @@
+#ifndef CONTADOR_MEMORIA_H
+#define CONTADOR_MEMORIA_H
+
+#include <cstdio>   // Para printf (C puro, sin STL)
+#include <cstdlib>  // Para malloc, free
+#include <cstddef>  // Para size_t
+#include <cstring>  // Para memset
+#include <pthread.h> // Para el candado del registro de hilos
+
+/**
+ * @brief Cada cuanto crecimiento de un hilo reviso el pico global
+ * 
+ * Revisar el pico obliga a sumar las cuentas de todos los hilos; con este
+ * paso solo se hace cuando un hilo crecio 64 KB desde su ultimo punto
+ * bajo. El pico puede quedarse corto hasta en PASO_PICO_MEMORIA bytes por
+ * hilo vivo.
+ */
+static const long long PASO_PICO_MEMORIA = 64 * 1024;
+
+/**
+ * @brief Cuentas de memoria de un solo hilo
+ * 
+ * Solo el hilo duenio escribe (lectura y guardado relajados, sin
+ * instrucciones con lock); el reporte las suma cuando se piden. Los bytes
+ * vivos de un hilo pueden ser negativos si libera lo que pidio otro.
+ * Ocupa una linea de cache entera para no compartirla con otro hilo.
+ */
+struct CuentaMemoriaHilo {
+    long long bytesVivos;
+    long long asignaciones;
+    long long liberaciones;
+    long long umbralPico;          // Al pasar estos bytes vivos reviso el pico global
+    CuentaMemoriaHilo* siguiente;  // Siguiente hilo registrado
+    char relleno[64 - 4 * sizeof(long long) - sizeof(void*)];
+    
+    /**
+     * @brief Suma a un contador propio (solo desde el hilo duenio)
+     * @param campo Contador de este bloque
+     * @param cantidad Lo que se suma
+     * @return Valor nuevo
+     */
+    static long long sumar(long long& campo, long long cantidad) {
+        long long n = __atomic_load_n(&campo, __ATOMIC_RELAXED) + cantidad;
+        __atomic_store_n(&campo, n, __ATOMIC_RELAXED);
+        return n;
+    }
+};
+
+/**
+ * @brief Bytes vivos y pico de un solo duenio (una lista de gestion)
+ * 
+ * El duenio suma y resta lo que reserva a su nombre; ContadorMemoria
+ * sigue contando lo mismo para todo el proceso. Sin atomicos: la usa un
+ * solo hilo a la vez, como la lista de gestion duenia.
+ */
+struct CuentaBytes {
+    long long vivos;  // Bytes reservados que no se han devuelto
+    long long pico;   // Mayor valor de vivos
+    
+    /**
+     * @brief Constructor que deja la cuenta en cero
+     */
+    CuentaBytes() : vivos(0), pico(0) {}
+    
+    /**
+     * @brief Anota una reserva
+     * @param bytes Tamanio reservado
+     */
+    void sumar(long long bytes) {
+        vivos += bytes;
+        if (vivos > pico) pico = vivos;
+    }
+    
+    /**
+     * @brief Anota una devolucion
+     * @param bytes Tamanio devuelto
+     */
+    void restar(long long bytes) {
+        vivos -= bytes;
+    }
+};
+
+/**
+ * @brief Contador global de la memoria que piden nodos y sensores
+ * 
+ * Nodo<T>, NodoGestion y SensorBase piden su memoria a traves de este
+ * contador (con su propio operator new/delete), asi que en cualquier
+ * momento se sabe cuantos bytes estan vivos, el pico historico y
+ * cuantas asignaciones hubo. Igual que Metricas, cada hilo cuenta en su
+ * propio bloque y los totales se suman al pedirlos, asi que pedir() y
+ * devolver() no tocan ninguna linea de cache compartida; por eso se
+ * puede dejar encendido en produccion.
+ */
+class ContadorMemoria {
+private:
+    /**
+     * @brief Estado compartido (uno solo para todo el proceso)
+     */
+    struct Estado {
+        CuentaMemoriaHilo* cabeza;     // Bloques de los hilos vivos
+        CuentaMemoriaHilo* libres;     // Bloques de hilos que terminaron, para reciclar
+        CuentaMemoriaHilo retirados;   // Suma de lo que contaron los hilos que terminaron
+        long long picoBytes;           // Solo se escribe con el candado tomado
+        pthread_mutex_t candado;       // Protege las listas, los retirados y el pico
+        pthread_key_t clave;           // Su destructor retira el bloque al terminar el hilo
+    };
+    
+    /**
+     * @brief Acceso al estado compartido
+     * @return Referencia al estado
+     */
+    static Estado& estado() {
+        struct Inicial {
+            Estado e;
+            Inicial() {
+                memset(&e, 0, sizeof(e));
+                pthread_mutex_init(&e.candado, NULL);
+                pthread_key_create(&e.clave, retirarHilo);
+            }
+        };
+        static Inicial inicial;
+        return inicial.e;
+    }
+    
+    /**
+     * @brief Bloque del hilo actual
+     * @return Referencia al puntero thread_local (NULL hasta el primer uso)
+     */
+    static CuentaMemoriaHilo*& propia() {
+        static thread_local CuentaMemoriaHilo* bloque = NULL;
+        return bloque;
+    }
+    
+    /**
+     * @brief Toma un bloque (reciclado si hay) y lo registra para el hilo actual
+     * @return Bloque del hilo
+     */
+    static CuentaMemoriaHilo* __attribute__((noinline)) registrarHilo() {
+        Estado& e = estado();
+        pthread_mutex_lock(&e.candado);
+        CuentaMemoriaHilo* bloque = e.libres;
+        if (bloque != NULL) {
+            e.libres = bloque->siguiente;
+        } else {
+            void* memoria = NULL;
+            if (posix_memalign(&memoria, 64, sizeof(CuentaMemoriaHilo)) != 0) {
+                pthread_mutex_unlock(&e.candado);
+                printf("[Memoria] Error: no hay memoria para el contador del hilo.\n");
+                abort();
+            }
+            bloque = (CuentaMemoriaHilo*)memoria;
+        }
+        memset(bloque, 0, sizeof(CuentaMemoriaHilo));
+        bloque->umbralPico = PASO_PICO_MEMORIA;
+        bloque->siguiente = e.cabeza;
+        e.cabeza = bloque;
+        pthread_mutex_unlock(&e.candado);
+        pthread_setspecific(e.clave, bloque);
+        propia() = bloque;
+        return bloque;
+    }
+    
+    /**
+     * @brief Pasa las cuentas de un hilo que termina a los retirados y recicla su bloque
+     * @param arg Bloque del hilo (lo llama pthread al salir el hilo)
+     */
+    static void retirarHilo(void* arg) {
+        CuentaMemoriaHilo* bloque = (CuentaMemoriaHilo*)arg;
+        Estado& e = estado();
+        pthread_mutex_lock(&e.candado);
+        CuentaMemoriaHilo** enlace = &e.cabeza;
+        while (*enlace != NULL && *enlace != bloque) enlace = &(*enlace)->siguiente;
+        if (*enlace == bloque) *enlace = bloque->siguiente;
+        CuentaMemoriaHilo::sumar(e.retirados.bytesVivos, bloque->bytesVivos);
+        CuentaMemoriaHilo::sumar(e.retirados.asignaciones, bloque->asignaciones);
+        CuentaMemoriaHilo::sumar(e.retirados.liberaciones, bloque->liberaciones);
+        bloque->siguiente = e.libres;
+        e.libres = bloque;
+        pthread_mutex_unlock(&e.candado);
+        // Si el hilo aun pide memoria en otro destructor, se registra de nuevo
+        propia() = NULL;
+    }
+    
+    /**
+     * @brief Suma las cuentas de todos los hilos (con el candado tomado)
+     * @param total Bloque destino (se sobreescribe)
+     */
+    static void sumarTodo(CuentaMemoriaHilo& total) {
+        Estado& e = estado();
+        total.bytesVivos = __atomic_load_n(&e.retirados.bytesVivos, __ATOMIC_RELAXED);
+        total.asignaciones = __atomic_load_n(&e.retirados.asignaciones, __ATOMIC_RELAXED);
+        total.liberaciones = __atomic_load_n(&e.retirados.liberaciones, __ATOMIC_RELAXED);
+        for (CuentaMemoriaHilo* h = e.cabeza; h != NULL; h = h->siguiente) {
+            total.bytesVivos += __atomic_load_n(&h->bytesVivos, __ATOMIC_RELAXED);
+            total.asignaciones += __atomic_load_n(&h->asignaciones, __ATOMIC_RELAXED);
+            total.liberaciones += __atomic_load_n(&h->liberaciones, __ATOMIC_RELAXED);
+        }
+        // Sube el pico si lo que veo ahora lo rebasa
+        if (total.bytesVivos > e.picoBytes) {
+            __atomic_store_n(&e.picoBytes, total.bytesVivos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    /**
+     * @brief Suma las cuentas de todos los hilos tomando el candado
+     * @param total Bloque destino (se sobreescribe)
+     */
+    static void combinar(CuentaMemoriaHilo& total) {
+        Estado& e = estado();
+        pthread_mutex_lock(&e.candado);
+        sumarTodo(total);
+        pthread_mutex_unlock(&e.candado);
+    }
+    
+    /**
+     * @brief Camino lento de pedir(): el hilo crecio un paso, reviso el pico global
+     * @param bloque Bloque del hilo actual
+     */
+    static void __attribute__((noinline)) revisarPico(CuentaMemoriaHilo* bloque) {
+        bloque->umbralPico = bloque->bytesVivos + PASO_PICO_MEMORIA;
+        CuentaMemoriaHilo total;
+        combinar(total);
+    }
+
+public:
+    /**
+     * @brief Pide memoria y la anota
+     * @param bytes Tamanio solicitado
+     * @return Puntero a la memoria
+     */
+    static void* pedir(size_t bytes) {
+        void* p = malloc(bytes);
+        if (p == NULL) {
+            printf("[Memoria] Error: no hay memoria para %lu bytes.\n", (unsigned long)bytes);
+            abort();
+        }
+        CuentaMemoriaHilo* c = propia();
+        if (__builtin_expect(c == NULL, 0)) c = registrarHilo();
+        long long vivos = CuentaMemoriaHilo::sumar(c->bytesVivos, (long long)bytes);
+        CuentaMemoriaHilo::sumar(c->asignaciones, 1);
+        if (__builtin_expect(vivos > c->umbralPico, 0)) revisarPico(c);
+        return p;
+    }
+    
+    /**
+     * @brief Devuelve memoria y la descuenta
+     * @param p Puntero obtenido con pedir()
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void devolver(void* p, size_t bytes) {
+        if (p == NULL) return;
+        CuentaMemoriaHilo* c = propia();
+        if (__builtin_expect(c == NULL, 0)) c = registrarHilo();
+        long long vivos = CuentaMemoriaHilo::sumar(c->bytesVivos, -(long long)bytes);
+        CuentaMemoriaHilo::sumar(c->liberaciones, 1);
+        // El umbral sigue al punto mas bajo: crecer un paso desde aqui revisa el pico
+        if (vivos + PASO_PICO_MEMORIA < c->umbralPico) c->umbralPico = vivos + PASO_PICO_MEMORIA;
+        free(p);
+    }
+    
+    /**
+     * @brief Bytes pedidos que aun no se devuelven
+     * @return Bytes vivos (suma de todos los hilos)
+     */
+    static long long bytesVivos() {
+        CuentaMemoriaHilo total;
+        combinar(total);
+        return total.bytesVivos;
+    }
+    
+    /**
+     * @brief Mayor cantidad de bytes vivos que se ha visto
+     * @return Pico en bytes (corto hasta en PASO_PICO_MEMORIA por hilo vivo)
+     */
+    static long long picoBytes() {
+        CuentaMemoriaHilo total;
+        combinar(total);
+        return __atomic_load_n(&estado().picoBytes, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Total de asignaciones desde que arranco el programa
+     * @return Cantidad de llamadas a pedir()
+     */
+    static long long asignaciones() {
+        CuentaMemoriaHilo total;
+        combinar(total);
+        return total.asignaciones;
+    }
+    
+    /**
+     * @brief Total de liberaciones desde que arranco el programa
+     * @return Cantidad de llamadas a devolver()
+     */
+    static long long liberaciones() {
+        CuentaMemoriaHilo total;
+        combinar(total);
+        return total.liberaciones;
+    }
+    
+    /**
+     * @brief Baja el pico al valor actual (para medir una fase en particular)
+     */
+    static void reiniciarPico() {
+        Estado& e = estado();
+        pthread_mutex_lock(&e.candado);
+        __atomic_store_n(&e.picoBytes, 0, __ATOMIC_RELAXED);
+        CuentaMemoriaHilo total;
+        sumarTodo(total);
+        pthread_mutex_unlock(&e.candado);
+    }
+    
+    /**
+     * @brief Muestra el resumen global
+     */
+    static void imprimirResumen() {
+        CuentaMemoriaHilo total;
+        combinar(total);
+        printf("Memoria contada: %.1f KB vivos, pico %.1f KB, %lld asignaciones, %lld liberaciones\n",
+               total.bytesVivos / 1024.0, __atomic_load_n(&estado().picoBytes, __ATOMIC_RELAXED) / 1024.0,
+               total.asignaciones, total.liberaciones);
+    }
+};
+
+#endif // CONTADOR_MEMORIA_H
\ No newline at end of file
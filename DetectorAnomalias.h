@@ -0,0 +1,411 @@
+#ifndef DETECTOR_ANOMALIAS_H
+#define DETECTOR_ANOMALIAS_H
+
+#include <cstdio>   // Para printf (C puro, sin STL)
+#include <cstring>  // Para memset
+#include <cmath>    // Para fabs, sqrt, HUGE_VAL
+#include <new>      // Para construir el detector dentro de una arena
+#include "ContadorMemoria.h"
+#include "ArenaBloques.h"
+
+/** @brief Cuatro double en un vector (extension de GCC/Clang; SSE2, AVX o NEON segun el destino) */
+typedef double VectorDoble __attribute__((vector_size(32)));
+
+/** @brief Cuatro enteros de 64 bits, resultado de comparar dos VectorDoble */
+typedef long long VectorMarca __attribute__((vector_size(32)));
+
+/**
+ * @brief Motivos por los que una lectura se marca como anomala (se combinan)
+ */
+enum TipoAnomalia {
+    ANOMALIA_Z = 1,       // Lejos de la media de la ventana (z-score)
+    ANOMALIA_EWMA = 2,    // Lejos del promedio exponencial
+    ANOMALIA_CAMBIO = 4,  // Salto demasiado grande contra la lectura anterior
+    ANOMALIA_INVALIDA = 8 // NaN o infinito: nunca se guarda, ni en modo solo marcar
+};
+
+/**
+ * @brief Parametros del detector de un sensor
+ */
+struct ConfigDetector {
+    int ventana;              // Lecturas en la ventana deslizante (se redondea a potencia de dos)
+    int minimoMuestras;       // Lecturas aceptadas antes de usar z-score y EWMA
+    double umbralZ;           // Anomala si |x - media| > umbralZ * desviacion
+    double alfaEwma;          // Peso de la lectura nueva en el promedio exponencial
+    double umbralEwma;        // Anomala si |x - ewma| > umbralEwma * desviacion
+    double cambioMaximo;      // Salto permitido contra la ultima lectura aceptada
+    double desviacionMinima;  // Piso de la desviacion (senales casi constantes)
+    int rachaMaxima;          // Anomalias seguidas que tomo como cambio de nivel real
+    bool cuarentena;          // true: las anomalias no llegan al historial
+    
+    /**
+     * @brief Constructor con valores genericos (sin limite de cambio)
+     */
+    ConfigDetector() : ventana(64), minimoMuestras(16), umbralZ(4.0), alfaEwma(0.2),
+                       umbralEwma(4.0), cambioMaximo(HUGE_VAL), desviacionMinima(1e-3),
+                       rachaMaxima(16), cuarentena(true) {}
+};
+
+/**
+ * @brief Deteccion de anomalias en linea para un sensor
+ * 
+ * Mantiene una ventana deslizante de las ultimas lecturas aceptadas
+ * (suma y suma de cuadrados para media y desviacion), un promedio
+ * exponencial (EWMA) y la ultima lectura aceptada para el limite de
+ * cambio. Las anomalias no entran a la ventana, asi que un pico no
+ * contamina las estadisticas.
+ * 
+ * Para ir rapido los lotes se revisan por tramos de TRAMO lecturas: la
+ * media, la desviacion y la EWMA se congelan al inicio del tramo y la
+ * prueba z/EWMA de todo el tramo es un ciclo sin saltos que el
+ * compilador vectoriza. Despues una pasada secuencial aplica el limite
+ * de cambio y actualiza la ventana con las lecturas aceptadas.
+ * 
+ * Si llegan rachaMaxima anomalias seguidas asumo que la senal cambio de
+ * nivel de verdad: reinicio la ventana y vuelvo a aprender.
+ * 
+ * Las lecturas que no son finitas (NaN, infinito) se descartan antes de
+ * las pruebas: un NaN pasa todas las comparaciones y envenenaria la suma
+ * y la EWMA para siempre. No cuentan para la racha.
+ */
+class DetectorAnomalias {
+public:
+    static const int TRAMO = 64;  // Lecturas por tramo con estadisticas congeladas
+
+private:
+    ConfigDetector config;
+    double* anillo;        // Ventana de lecturas aceptadas (se pide al primer uso)
+    ArenaBloques* origen;  // Arena de la que salen el detector y su ventana, NULL si del contador
+    int mascara;           // Capacidad de la ventana - 1
+    int posicion;          // Donde escribo la siguiente lectura
+    int llenos;            // Lecturas validas en la ventana
+    double suma;           // Suma de la ventana
+    double sumaCuadrados;  // Suma de cuadrados de la ventana
+    double ewma;           // Promedio exponencial de las aceptadas
+    double ultima;         // Ultima lectura aceptada
+    bool hayUltima;        // false hasta la primera lectura aceptada
+    int racha;             // Anomalias seguidas
+    
+    long long revisadas;       // Lecturas que pasaron por el detector
+    long long porMotivo[4];    // Anomalias por z, EWMA, cambio y valor invalido
+    long long anomalas;        // Lecturas marcadas (por cualquier motivo)
+    long long reinicios;       // Cambios de nivel aceptados
+    double ultimaAnomala;      // Valor de la ultima lectura marcada
+    
+    /**
+     * @brief Marca las lecturas de un tramo contra estadisticas fijas
+     * 
+     * Proceso cuatro lecturas por vuelta con vectores de GCC: el
+     * compilador no vectoriza solo una comparacion que produce enteros,
+     * asi que se lo escribo explicito. Las marcas son de 64 bits como los
+     * double para que cada comparacion llene su carril sin empacar.
+     * 
+     * @param x Lecturas del tramo
+     * @param n Cuantas son
+     * @param media Media de la ventana
+     * @param centroEwma EWMA al inicio del tramo
+     * @param limiteZ2 Cuadrado de la distancia maxima a la media
+     * @param limiteEwma2 Cuadrado de la distancia maxima a la EWMA
+     * @param marcas Salida: combinacion de ANOMALIA_Z y ANOMALIA_EWMA
+     */
+    static void marcarTramo(const double* x, int n, double media, double centroEwma,
+                            double limiteZ2, double limiteEwma2, long long* marcas) {
+        const int ANCHO = sizeof(VectorDoble) / sizeof(double);
+        int i = 0;
+        for (; i + ANCHO <= n; i += ANCHO) {
+            VectorDoble v;
+            memcpy(&v, x + i, sizeof(v));  // Carga sin exigir alineacion
+            VectorDoble dz = v - media;
+            VectorDoble de = v - centroEwma;
+            VectorMarca m = ((dz * dz > limiteZ2) & (long long)ANOMALIA_Z) |
+                            ((de * de > limiteEwma2) & (long long)ANOMALIA_EWMA);
+            memcpy(marcas + i, &m, sizeof(m));
+        }
+        for (; i < n; i++) {
+            double dz = x[i] - media;
+            double de = x[i] - centroEwma;
+            marcas[i] = (dz * dz > limiteZ2 ? ANOMALIA_Z : 0) | (de * de > limiteEwma2 ? ANOMALIA_EWMA : 0);
+        }
+    }
+    
+    /**
+     * @brief Agrega una lectura aceptada a la ventana y a la EWMA
+     * @param valor Lectura aceptada
+     */
+    void aceptar(double valor) {
+        if (llenos > mascara) {
+            double viejo = anillo[posicion];
+            suma -= viejo;
+            sumaCuadrados -= viejo * viejo;
+        } else {
+            llenos++;
+        }
+        anillo[posicion] = valor;
+        suma += valor;
+        sumaCuadrados += valor * valor;
+        posicion = (posicion + 1) & mascara;
+        
+        // En cada vuelta recalculo las sumas para que no se acumule error
+        if (posicion == 0) {
+            suma = 0.0;
+            sumaCuadrados = 0.0;
+            for (int i = 0; i <= mascara; i++) {
+                suma += anillo[i];
+                sumaCuadrados += anillo[i] * anillo[i];
+            }
+        }
+        
+        ewma = hayUltima ? ewma + config.alfaEwma * (valor - ewma) : valor;
+        ultima = valor;
+        hayUltima = true;
+    }
+    
+    /**
+     * @brief Pide la ventana a donde salio el detector
+     * @return Espacio para config.ventana lecturas
+     */
+    double* pedirVentana() const {
+        size_t bytes = sizeof(double) * config.ventana;
+        return (double*)(origen != NULL ? origen->tomarBytes(bytes) : ContadorMemoria::pedir(bytes));
+    }
+    
+    /**
+     * @brief Olvida la ventana (para aprender un nivel nuevo)
+     */
+    void reiniciarVentana() {
+        posicion = 0;
+        llenos = 0;
+        suma = 0.0;
+        sumaCuadrados = 0.0;
+        hayUltima = false;
+        racha = 0;
+    }
+
+public:
+    /**
+     * @brief Constructor; la ventana se pide hasta la primera lectura
+     * @param configuracion Parametros del detector
+     */
+    DetectorAnomalias(const ConfigDetector& configuracion)
+        : config(configuracion), anillo(NULL), origen(NULL), mascara(0), ewma(0.0), ultima(0.0),
+          revisadas(0), anomalas(0), reinicios(0), ultimaAnomala(0.0) {
+        int capacidad = 4;
+        while (capacidad < config.ventana) capacidad *= 2;
+        config.ventana = capacidad;
+        if (config.minimoMuestras > capacidad) config.minimoMuestras = capacidad;
+        if (config.rachaMaxima < 1) config.rachaMaxima = 1;
+        mascara = capacidad - 1;
+        memset(porMotivo, 0, sizeof(porMotivo));
+        reiniciarVentana();
+    }
+    
+    /**
+     * @brief Destructor que devuelve la ventana
+     */
+    ~DetectorAnomalias() {
+        if (anillo == NULL) return;
+        if (origen != NULL) {
+            origen->devolverBytes(anillo, sizeof(double) * config.ventana);
+        } else {
+            ContadorMemoria::devolver(anillo, sizeof(double) * config.ventana);
+        }
+    }
+    
+    /**
+     * @brief Crea un detector en una arena o con el contador global
+     * @param configuracion Parametros del detector
+     * @param arena Arena de donde salen el detector y su ventana, NULL para el contador
+     * @return Detector nuevo (se libera con destruir)
+     */
+    static DetectorAnomalias* crear(const ConfigDetector& configuracion, ArenaBloques* arena) {
+        if (arena == NULL) return new DetectorAnomalias(configuracion);
+        DetectorAnomalias* detector = ::new (arena->tomarBytes(sizeof(DetectorAnomalias)))
+            DetectorAnomalias(configuracion);
+        detector->origen = arena;
+        return detector;
+    }
+    
+    /**
+     * @brief Libera un detector de crear()
+     * 
+     * Si su arena se esta cerrando no hace nada: la memoria se va con
+     * los trozos.
+     * 
+     * @param detector Detector a liberar (puede ser NULL)
+     */
+    static void destruir(DetectorAnomalias* detector) {
+        if (detector == NULL) return;
+        ArenaBloques* arena = detector->origen;
+        if (arena == NULL) {
+            delete detector;
+        } else if (!arena->enCierre()) {
+            detector->~DetectorAnomalias();
+            arena->devolverBytes(detector, sizeof(DetectorAnomalias));
+        }
+    }
+    
+    /**
+     * @brief Pasa un detector (con su ventana y contadores) a otra arena
+     * @param detector Detector de crear() (puede ser NULL)
+     * @param arena Arena destino, NULL para el contador
+     * @return El detector en su nuevo lugar; el anterior ya no vale
+     */
+    static DetectorAnomalias* mudar(DetectorAnomalias* detector, ArenaBloques* arena) {
+        if (detector == NULL || detector->origen == arena) return detector;
+        DetectorAnomalias* nuevo = crear(detector->config, arena);
+        *nuevo = *detector;
+        nuevo->origen = arena;
+        if (detector->anillo != NULL) {
+            nuevo->anillo = nuevo->pedirVentana();
+            memcpy(nuevo->anillo, detector->anillo, sizeof(double) * detector->config.ventana);
+        }
+        destruir(detector);
+        return nuevo;
+    }
+    
+    /**
+     * @brief Revisa un lote y deja en aceptados lo que debe ir al historial
+     * 
+     * En modo cuarentena las anomalias se quedan fuera; si no, pasan
+     * todas y solo se cuentan y marcan.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas
+     * @param aceptados Salida (cabe al menos cantidad); puede ser el mismo arreglo que valores
+     * @param marcas Salida opcional por lectura (0 = normal), puede ser NULL
+     * @return Cuantas lecturas deje en aceptados
+     */
+    int filtrar(const double* valores, int cantidad, double* aceptados, unsigned char* marcas = NULL) {
+        if (cantidad <= 0) return 0;
+        if (anillo == NULL) anillo = pedirVentana();
+        revisadas += cantidad;
+        
+        long long marcasTramo[TRAMO];
+        int salida = 0;
+        int hechas = 0;
+        while (hechas < cantidad) {
+            int n = cantidad - hechas;
+            if (n > TRAMO) n = TRAMO;
+            const double* x = valores + hechas;
+            
+            // Estadisticas congeladas para todo el tramo
+            double media = 0.0;
+            double limiteZ2 = HUGE_VAL;
+            double limiteEwma2 = HUGE_VAL;
+            if (llenos >= config.minimoMuestras) {
+                media = suma / llenos;
+                double varianza = sumaCuadrados / llenos - media * media;
+                double piso = config.desviacionMinima * config.desviacionMinima;
+                if (varianza < piso) varianza = piso;
+                limiteZ2 = config.umbralZ * config.umbralZ * varianza;
+                limiteEwma2 = config.umbralEwma * config.umbralEwma * varianza;
+            }
+            marcarTramo(x, n, media, ewma, limiteZ2, limiteEwma2, marcasTramo);
+            
+            // Pasada secuencial: limite de cambio y actualizacion de la ventana
+            int i = 0;
+            bool reinicie = false;
+            while (i < n && !reinicie) {
+                double v = x[i];
+                if (!__builtin_isfinite(v)) {
+                    anomalas++;
+                    porMotivo[3]++;
+                    if (marcas != NULL) marcas[hechas + i] = ANOMALIA_INVALIDA;
+                    i++;
+                    continue;
+                }
+                int marca = (int)marcasTramo[i];
+                if (hayUltima && fabs(v - ultima) > config.cambioMaximo) marca |= ANOMALIA_CAMBIO;
+                
+                if (marca != 0 && ++racha >= config.rachaMaxima) {
+                    // Demasiadas seguidas: es un nivel nuevo, no un pico
+                    reiniciarVentana();
+                    reinicios++;
+                    marca = 0;
+                    reinicie = true;  // Las estadisticas del tramo ya no sirven
+                }
+                
+                if (marca != 0) {
+                    anomalas++;
+                    porMotivo[0] += marca & ANOMALIA_Z;
+                    porMotivo[1] += (marca & ANOMALIA_EWMA) >> 1;
+                    porMotivo[2] += (marca & ANOMALIA_CAMBIO) >> 2;
+                    ultimaAnomala = v;
+                    if (!config.cuarentena) aceptados[salida++] = v;
+                } else {
+                    racha = 0;
+                    aceptar(v);
+                    aceptados[salida++] = v;
+                }
+                if (marcas != NULL) marcas[hechas + i] = (unsigned char)marca;
+                i++;
+            }
+            hechas += i;
+        }
+        return salida;
+    }
+    
+    /**
+     * @brief Bytes del detector y su ventana
+     * @return Memoria en bytes
+     */
+    size_t bytesUsados() const {
+        return sizeof(*this) + (anillo != NULL ? sizeof(double) * config.ventana : 0);
+    }
+    
+    /**
+     * @brief Lecturas revisadas
+     * @return Total
+     */
+    long long obtenerRevisadas() const {
+        return revisadas;
+    }
+    
+    /**
+     * @brief Lecturas marcadas como anomalas
+     * @return Total
+     */
+    long long obtenerAnomalas() const {
+        return anomalas;
+    }
+    
+    /**
+     * @brief Configuracion en uso
+     * @return Parametros (con la ventana ya redondeada)
+     */
+    const ConfigDetector& obtenerConfig() const {
+        return config;
+    }
+    
+    /**
+     * @brief Muestra los contadores del detector
+     */
+    void imprimirResumen() const {
+        printf("Anomalias: %lld de %lld lecturas (z: %lld, ewma: %lld, cambio: %lld, invalidas: %lld), %s",
+               anomalas, revisadas, porMotivo[0], porMotivo[1], porMotivo[2], porMotivo[3],
+               config.cuarentena ? "en cuarentena" : "solo marcadas");
+        if (anomalas > 0) printf(", ultima: %.2f", ultimaAnomala);
+        if (reinicios > 0) printf(", cambios de nivel: %lld", reinicios);
+        printf("\n");
+    }
+    
+    /**
+     * @brief Pido la memoria del detector a traves del contador global
+     * @param bytes Tamanio que pide el compilador
+     * @return Memoria para el detector
+     */
+    static void* operator new(size_t bytes) {
+        return ContadorMemoria::pedir(bytes);
+    }
+    
+    /**
+     * @brief Devuelvo la memoria del detector al contador global
+     * @param p Memoria del detector
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void operator delete(void* p, size_t bytes) {
+        ContadorMemoria::devolver(p, bytes);
+    }
+};
+
+#endif // DETECTOR_ANOMALIAS_H
\ No newline at end of file
@@ -0,0 +1,732 @@
+#ifndef EXPORTADOR_COLUMNAR_H
+#define EXPORTADOR_COLUMNAR_H
+
+#include <cstdio>      // Para printf (C puro, sin STL)
+#include <cstdlib>     // Para malloc, realloc, free
+#include <cstring>     // Para memcpy, memcmp
+#include <fcntl.h>     // Para open
+#include <unistd.h>    // Para read, write, close
+#include <sys/stat.h>  // Para fstat
+#include <sys/uio.h>   // Para writev
+#include "ListaGestion.h"
+#include "RegistroTipos.h"
+
+/**
+ * @file ExportadorColumnar.h
+ * @brief Exporta e importa los historiales en un formato binario por columnas
+ * 
+ * Formato (little-endian):
+ *   - Encabezado: "SIOTCOL1", u32 sensores, u64 lecturas totales
+ *   - Diccionario: por sensor u8 tipo, u8 largo del nombre, nombre
+ *   - Bloques de hasta FILAS_POR_BLOQUE lecturas, cada uno con
+ *     u32 "CHNK", u32 filas, u32 corridas y el tamanio de tres columnas:
+ *       1. corridas: (indice de sensor, tipo, cantidad) en varint; es la
+ *          columna de sensor y de tipo comprimida por repeticion (RLE)
+ *       2. tiempos: por corrida el primer numero de secuencia y pares
+ *          (delta, repeticiones); hoy las lecturas no traen hora, asi
+ *          que el "tiempo" es la posicion dentro del historial
+ *       3. valores: enteros como delta en zigzag+varint; flotantes como
+ *          XOR contra el anterior guardando solo los bytes distintos de cero
+ * 
+ * Cada bloque se arma en memoria y se escribe con un solo writev.
+ */
+
+/**
+ * @brief Arreglo de bytes que crece solo (sin STL)
+ */
+class BufferBytes {
+private:
+    unsigned char* datos;
+    size_t usado;
+    size_t capacidad;
+    
+    // No se copia: es duenio de su memoria
+    BufferBytes(const BufferBytes&);
+    BufferBytes& operator=(const BufferBytes&);
+
+public:
+    /**
+     * @brief Constructor con capacidad inicial
+     * @param inicial Bytes a reservar de entrada
+     */
+    BufferBytes(size_t inicial) : usado(0), capacidad(inicial < 16 ? 16 : inicial) {
+        datos = (unsigned char*)malloc(capacidad);
+    }
+    
+    /**
+     * @brief Destructor que libera el arreglo
+     */
+    ~BufferBytes() {
+        free(datos);
+    }
+    
+    /**
+     * @brief Me aseguro de tener espacio para "extra" bytes mas
+     * @param extra Bytes que voy a escribir
+     */
+    void asegurar(size_t extra) {
+        if (usado + extra <= capacidad) return;
+        while (usado + extra > capacidad) capacidad *= 2;
+        datos = (unsigned char*)realloc(datos, capacidad);
+    }
+    
+    /**
+     * @brief Agrega un byte
+     * @param b Byte a agregar
+     */
+    void agregarByte(unsigned char b) {
+        asegurar(1);
+        datos[usado++] = b;
+    }
+    
+    /**
+     * @brief Agrega un arreglo de bytes
+     * @param p Bytes de origen
+     * @param n Cuantos bytes
+     */
+    void agregarBytes(const void* p, size_t n) {
+        asegurar(n);
+        memcpy(datos + usado, p, n);
+        usado += n;
+    }
+    
+    /**
+     * @brief Agrega un entero sin signo en varint (7 bits por byte)
+     * @param v Valor a codificar
+     */
+    void agregarVarint(unsigned long long v) {
+        asegurar(10);
+        while (v >= 0x80) {
+            datos[usado++] = (unsigned char)(v | 0x80);
+            v >>= 7;
+        }
+        datos[usado++] = (unsigned char)v;
+    }
+    
+    /**
+     * @brief Vacia el buffer sin soltar la memoria
+     */
+    void limpiar() {
+        usado = 0;
+    }
+    
+    /**
+     * @brief Puntero al inicio de los datos
+     * @return Datos escritos
+     */
+    unsigned char* obtenerDatos() const {
+        return datos;
+    }
+    
+    /**
+     * @brief Cantidad de bytes escritos
+     * @return Tamanio usado
+     */
+    size_t obtenerTamanio() const {
+        return usado;
+    }
+};
+
+/**
+ * @brief Lectura secuencial de un rango de bytes ya cargado en memoria
+ */
+struct LectorBytes {
+    const unsigned char* actual;
+    const unsigned char* fin;
+    bool error;  // Se prende si intento leer mas alla del final
+    
+    /**
+     * @brief Constructor sobre un rango de memoria
+     * @param datos Inicio del rango
+     * @param n Cuantos bytes hay
+     */
+    LectorBytes(const unsigned char* datos, size_t n) : actual(datos), fin(datos + n), error(false) {}
+    
+    /**
+     * @brief Lee un byte
+     * @return El byte, 0 si ya no hay
+     */
+    unsigned char leerByte() {
+        if (actual >= fin) {
+            error = true;
+            return 0;
+        }
+        return *actual++;
+    }
+    
+    /**
+     * @brief Lee un varint
+     * @return El valor decodificado
+     */
+    unsigned long long leerVarint() {
+        unsigned long long v = 0;
+        int corrimiento = 0;
+        while (actual < fin && corrimiento < 64) {
+            unsigned char b = *actual++;
+            v |= (unsigned long long)(b & 0x7F) << corrimiento;
+            if ((b & 0x80) == 0) return v;
+            corrimiento += 7;
+        }
+        error = true;
+        return 0;
+    }
+};
+
+/**
+ * @brief Exportador e importador de historiales por columnas
+ */
+class ExportadorColumnar {
+public:
+    static const int FILAS_POR_BLOQUE = 65536;  // Lecturas maximas por bloque
+
+private:
+    static const unsigned MAGIA_BLOQUE = 0x4B4E4843u;  // "CHNK" en little-endian
+    
+    /**
+     * @brief Indica si un tipo de sensor guarda enteros
+     * @param tipo Codigo del sensor
+     * @return true si el registro dice que sus lecturas son enteras
+     */
+    static bool esTipoEntero(char tipo) {
+        const TipoSensor* registrado = RegistroTipos::buscar(tipo);
+        return registrado != NULL && registrado->entero;
+    }
+    
+    /**
+     * @brief Convierte un entero con signo a sin signo (los chicos quedan chicos)
+     * @param v Valor con signo
+     * @return Valor en zigzag
+     */
+    static unsigned long long zigzag(long long v) {
+        return ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63);
+    }
+    
+    /**
+     * @brief Inverso de zigzag
+     * @param u Valor en zigzag
+     * @return Valor con signo
+     */
+    static long long deszigzag(unsigned long long u) {
+        return (long long)(u >> 1) ^ -(long long)(u & 1);
+    }
+    
+    /**
+     * @brief Escribe todos los bytes de varios buffers, aunque writev escriba de a poco
+     * @param fd Archivo destino
+     * @param partes Arreglo de iovec (se modifica)
+     * @param cuantas Cuantas partes hay
+     * @return false si hubo error de escritura
+     */
+    static bool escribirTodo(int fd, iovec* partes, int cuantas) {
+        while (cuantas > 0) {
+            ssize_t n = writev(fd, partes, cuantas);
+            if (n < 0) return false;
+            // Avanzo sobre lo que ya se escribio
+            while (cuantas > 0 && (size_t)n >= partes->iov_len) {
+                n -= partes->iov_len;
+                partes++;
+                cuantas--;
+            }
+            if (cuantas > 0) {
+                partes->iov_base = (char*)partes->iov_base + n;
+                partes->iov_len -= n;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Codifica los valores de una corrida en la columna de valores
+     * @param columna Columna destino
+     * @param valores Lecturas como double
+     * @param n Cuantas lecturas
+     * @param entero true si el sensor guarda enteros
+     */
+    static void codificarValores(BufferBytes& columna, const double* valores, int n, bool entero) {
+        if (entero) {
+            long long anterior = 0;
+            for (int i = 0; i < n; i++) {
+                long long v = (long long)valores[i];
+                columna.agregarVarint(zigzag(v - anterior));
+                anterior = v;
+            }
+            return;
+        }
+        
+        // Flotantes: XOR contra el anterior y solo guardo los bytes del medio
+        columna.asegurar((size_t)n * 5);
+        unsigned anterior = 0;
+        for (int i = 0; i < n; i++) {
+            float f = (float)valores[i];
+            unsigned bits;
+            memcpy(&bits, &f, 4);
+            unsigned x = bits ^ anterior;
+            anterior = bits;
+            if (x == 0) {
+                columna.agregarByte(0x40);  // 4 bytes en cero al frente: igual al anterior
+                continue;
+            }
+            int ceroAlto = __builtin_clz(x) / 8;
+            int ceroBajo = __builtin_ctz(x) / 8;
+            columna.agregarByte((unsigned char)((ceroAlto << 4) | ceroBajo));
+            for (int b = ceroBajo; b < 4 - ceroAlto; b++) {
+                columna.agregarByte((unsigned char)(x >> (8 * b)));
+            }
+        }
+    }
+    
+    /**
+     * @brief Decodifica los valores de una corrida
+     * @param lector Columna de valores
+     * @param destino Arreglo destino
+     * @param n Cuantas lecturas
+     * @param entero true si el sensor guarda enteros
+     */
+    static void decodificarValores(LectorBytes& lector, double* destino, int n, bool entero) {
+        if (entero) {
+            long long anterior = 0;
+            for (int i = 0; i < n; i++) {
+                anterior += deszigzag(lector.leerVarint());
+                destino[i] = (double)anterior;
+            }
+            return;
+        }
+        
+        unsigned anterior = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned char encabezado = lector.leerByte();
+            int ceroAlto = encabezado >> 4;
+            int ceroBajo = encabezado & 0x0F;
+            unsigned x = 0;
+            for (int b = ceroBajo; b < 4 - ceroAlto; b++) {
+                x |= (unsigned)lector.leerByte() << (8 * b);
+            }
+            anterior ^= x;
+            float f;
+            memcpy(&f, &anterior, 4);
+            destino[i] = f;
+        }
+    }
+    
+    /**
+     * @brief Estado mientras exporto
+     */
+    struct Exportacion {
+        int fd;
+        SensorBase** sensores;
+        int cantidadSensores;
+        long long totalLecturas;
+        BufferBytes corridas;
+        BufferBytes tiempos;
+        BufferBytes valores;
+        int filas;          // Lecturas en el bloque actual
+        int corridasBloque; // Corridas en el bloque actual
+        long long bytes;    // Bytes escritos al archivo
+        bool error;
+        
+        /**
+         * @brief Constructor con buffers del tamanio de un bloque
+         */
+        Exportacion() : fd(-1), sensores(NULL), cantidadSensores(0), totalLecturas(0),
+                        corridas(4096), tiempos(4096), valores(FILAS_POR_BLOQUE * 5),
+                        filas(0), corridasBloque(0), bytes(0), error(false) {}
+    };
+    
+    /**
+     * @brief Visitante que junta los sensores en un arreglo
+     * @param sensor Sensor visitado
+     * @param contexto Estado de la exportacion
+     */
+    static void juntarSensor(SensorBase* sensor, void* contexto) {
+        Exportacion* e = (Exportacion*)contexto;
+        e->sensores[e->cantidadSensores++] = sensor;
+        e->totalLecturas += sensor->obtenerCantidadLecturas();
+    }
+    
+    /**
+     * @brief Escribe el bloque armado con un solo writev
+     * @param e Estado de la exportacion
+     */
+    static void escribirBloque(Exportacion& e) {
+        if (e.filas == 0 || e.error) return;
+        unsigned encabezado[6];
+        encabezado[0] = MAGIA_BLOQUE;
+        encabezado[1] = (unsigned)e.filas;
+        encabezado[2] = (unsigned)e.corridasBloque;
+        encabezado[3] = (unsigned)e.corridas.obtenerTamanio();
+        encabezado[4] = (unsigned)e.tiempos.obtenerTamanio();
+        encabezado[5] = (unsigned)e.valores.obtenerTamanio();
+        
+        iovec partes[4];
+        partes[0].iov_base = encabezado;
+        partes[0].iov_len = sizeof(encabezado);
+        partes[1].iov_base = e.corridas.obtenerDatos();
+        partes[1].iov_len = e.corridas.obtenerTamanio();
+        partes[2].iov_base = e.tiempos.obtenerDatos();
+        partes[2].iov_len = e.tiempos.obtenerTamanio();
+        partes[3].iov_base = e.valores.obtenerDatos();
+        partes[3].iov_len = e.valores.obtenerTamanio();
+        if (!escribirTodo(e.fd, partes, 4)) e.error = true;
+        
+        e.bytes += sizeof(encabezado) + e.corridas.obtenerTamanio() +
+                   e.tiempos.obtenerTamanio() + e.valores.obtenerTamanio();
+        e.corridas.limpiar();
+        e.tiempos.limpiar();
+        e.valores.limpiar();
+        e.filas = 0;
+        e.corridasBloque = 0;
+    }
+    
+    /**
+     * @brief Lector de archivo con buffer grande (pocas llamadas a read)
+     */
+    struct ArchivoEntrada {
+        int fd;
+        unsigned char* buffer;
+        size_t inicio;
+        size_t fin;
+        static const size_t CAPACIDAD = 1 << 22;  // 4 MB por lectura
+        
+        /**
+         * @brief Constructor sobre un archivo ya abierto
+         * @param archivo Descriptor de lectura
+         */
+        ArchivoEntrada(int archivo) : fd(archivo), inicio(0), fin(0) {
+            buffer = (unsigned char*)malloc(CAPACIDAD);
+        }
+        
+        /**
+         * @brief Destructor que libera el buffer (el archivo lo cierra quien lo abrio)
+         */
+        ~ArchivoEntrada() {
+            free(buffer);
+        }
+        
+        /**
+         * @brief Copia exactamente n bytes a destino
+         * @param destino Donde copio
+         * @param n Cuantos bytes
+         * @return false si el archivo se acabo antes
+         */
+        bool leer(void* destino, size_t n) {
+            unsigned char* salida = (unsigned char*)destino;
+            while (n > 0) {
+                if (inicio == fin) {
+                    ssize_t leidos = read(fd, buffer, CAPACIDAD);
+                    if (leidos <= 0) return false;
+                    inicio = 0;
+                    fin = (size_t)leidos;
+                }
+                size_t toma = fin - inicio;
+                if (toma > n) toma = n;
+                memcpy(salida, buffer + inicio, toma);
+                inicio += toma;
+                salida += toma;
+                n -= toma;
+            }
+            return true;
+        }
+    };
+    
+    /**
+     * @brief Crea un sensor vacio segun su codigo de tipo
+     * @param tipo Codigo de un tipo registrado
+     * @param nombre Identificador
+     * @return Sensor nuevo o NULL si el tipo no se conoce
+     */
+    static SensorBase* crearSensor(char tipo, const char* nombre) {
+        const TipoSensor* registrado = RegistroTipos::buscar(tipo);
+        return registrado != NULL ? registrado->crear(nombre) : NULL;
+    }
+
+public:
+    /**
+     * @brief Exporta todos los historiales de la lista de gestion
+     * @param sistema Lista con los sensores
+     * @param ruta Archivo destino (se sobreescribe)
+     * @return Bytes escritos, o -1 si hubo error
+     */
+    static long long exportar(const ListaGestion& sistema, const char* ruta) {
+        Exportacion e;
+        e.fd = open(ruta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (e.fd < 0) {
+            printf("[Exportador] Error: no pude abrir %s\n", ruta);
+            return -1;
+        }
+        
+        e.sensores = (SensorBase**)malloc(sizeof(SensorBase*) * (sistema.obtenerTamanio() + 1));
+        sistema.paraCadaSensor(juntarSensor, &e);
+        
+        // Encabezado y diccionario de sensores
+        BufferBytes cabecera(4096);
+        unsigned cantidad = (unsigned)e.cantidadSensores;
+        unsigned long long total = (unsigned long long)e.totalLecturas;
+        cabecera.agregarBytes("SIOTCOL1", 8);
+        cabecera.agregarBytes(&cantidad, 4);
+        cabecera.agregarBytes(&total, 8);
+        for (int k = 0; k < e.cantidadSensores; k++) {
+            const char* nombre = e.sensores[k]->obtenerNombre();
+            unsigned char largo = (unsigned char)strlen(nombre);
+            cabecera.agregarByte((unsigned char)e.sensores[k]->obtenerTipo());
+            cabecera.agregarByte(largo);
+            cabecera.agregarBytes(nombre, largo);
+        }
+        iovec parte;
+        parte.iov_base = cabecera.obtenerDatos();
+        parte.iov_len = cabecera.obtenerTamanio();
+        if (!escribirTodo(e.fd, &parte, 1)) e.error = true;
+        e.bytes += cabecera.obtenerTamanio();
+        
+        // Recorro cada historial por partes y voy llenando bloques
+        double* temporal = (double*)malloc(sizeof(double) * FILAS_POR_BLOQUE);
+        for (int k = 0; k < e.cantidadSensores && !e.error; k++) {
+            SensorBase* sensor = e.sensores[k];
+            char tipo = sensor->obtenerTipo();
+            CursorLecturas cursor;
+            long long secuencia = 0;
+            while (true) {
+                int n = sensor->copiarLecturas(temporal, FILAS_POR_BLOQUE - e.filas, cursor);
+                if (n == 0) break;
+                
+                e.corridas.agregarVarint((unsigned long long)k);
+                e.corridas.agregarByte((unsigned char)tipo);
+                e.corridas.agregarVarint((unsigned long long)n);
+                
+                // Secuencia: primer valor y un solo par (delta 1, n-1 repeticiones)
+                e.tiempos.agregarVarint((unsigned long long)secuencia);
+                e.tiempos.agregarVarint(n > 1 ? 1 : 0);
+                if (n > 1) {
+                    e.tiempos.agregarVarint(zigzag(1));
+                    e.tiempos.agregarVarint((unsigned long long)(n - 1));
+                }
+                
+                codificarValores(e.valores, temporal, n, esTipoEntero(tipo));
+                e.filas += n;
+                e.corridasBloque++;
+                secuencia += n;
+                if (e.filas == FILAS_POR_BLOQUE) escribirBloque(e);
+            }
+        }
+        escribirBloque(e);
+        
+        free(temporal);
+        free(e.sensores);
+        close(e.fd);
+        if (e.error) {
+            printf("[Exportador] Error al escribir %s\n", ruta);
+            return -1;
+        }
+        BITACORA("[Exportador] %d sensores, %lld lecturas, %lld bytes en %s\n",
+                 e.cantidadSensores, e.totalLecturas, e.bytes, ruta);
+        return e.bytes;
+    }
+    
+    /**
+     * @brief Carga un archivo exportado en la lista de gestion
+     * 
+     * Si un sensor ya existe (mismo ID) sus lecturas se agregan al final de
+     * su historial; si no, se crea del tipo que indica el archivo. Primero
+     * se lee y valida todo el diccionario: si un tipo no se conoce o no
+     * coincide con el del sensor que ya existe (o con otra entrada del
+     * mismo ID), el archivo se rechaza sin crear ni cargar nada.
+     * 
+     * Los bloques se aplican conforme se leen. Si uno esta danado la
+     * importacion se detiene y devuelve -1, pero los sensores creados y las
+     * lecturas de los bloques anteriores se quedan (el mensaje dice
+     * cuantas). Guardarlas todas para aplicarlas al final duplicaria la
+     * memoria de una importacion grande.
+     * 
+     * Las lecturas no pasan por el detector de anomalias: ya se filtraron
+     * cuando se registraron la primera vez.
+     * 
+     * @param sistema Lista destino
+     * @param ruta Archivo a leer
+     * @return Lecturas cargadas, o -1 si el archivo no es valido
+     */
+    static long long importar(ListaGestion& sistema, const char* ruta) {
+        int fd = open(ruta, O_RDONLY);
+        if (fd < 0) {
+            printf("[Importador] Error: no pude abrir %s\n", ruta);
+            return -1;
+        }
+        ArchivoEntrada archivo(fd);
+        
+        char magia[8];
+        unsigned cantidad = 0;
+        unsigned long long total = 0;
+        if (!archivo.leer(magia, 8) || memcmp(magia, "SIOTCOL1", 8) != 0 ||
+            !archivo.leer(&cantidad, 4) || !archivo.leer(&total, 8)) {
+            printf("[Importador] Error: %s no es un archivo columnar valido\n", ruta);
+            close(fd);
+            return -1;
+        }
+        
+        // Cada entrada del diccionario ocupa al menos 2 bytes: un conteo
+        // mayor que eso no viene de un archivo valido (y no pido memoria por el)
+        struct stat datosArchivo;
+        if (fstat(fd, &datosArchivo) != 0 || (unsigned long long)cantidad > (unsigned long long)datosArchivo.st_size / 2) {
+            printf("[Importador] Error: %s declara %u sensores y no le caben\n", ruta, cantidad);
+            close(fd);
+            return -1;
+        }
+        
+        SensorBase** sensores = (SensorBase**)malloc(sizeof(SensorBase*) * (cantidad + 1));
+        char* tipos = (char*)malloc(cantidad + 1);
+        int* origen = (int*)malloc(sizeof(int) * (cantidad + 1));                // Entrada que crea el sensor
+        unsigned* inicioNombre = (unsigned*)malloc(sizeof(unsigned) * (cantidad + 1));
+        size_t capacidadNuevos = 2;
+        while (capacidadNuevos < (size_t)cantidad * 2) capacidadNuevos <<= 1;
+        CasillaManifiesto* nuevos = (CasillaManifiesto*)calloc(capacidadNuevos, sizeof(CasillaManifiesto));
+        size_t capacidadNombres = 4096;
+        size_t usadosNombres = 0;
+        char* nombres = (char*)malloc(capacidadNombres);
+        bool valido = sensores != NULL && tipos != NULL && origen != NULL && inicioNombre != NULL &&
+                      nuevos != NULL && nombres != NULL;
+        bool avisado = false;  // Ya se imprimio el motivo, no es archivo danado
+        
+        // 1) Leo y valido todo el diccionario sin tocar la lista
+        for (unsigned k = 0; k < cantidad && valido; k++) {
+            unsigned char tipo = 0;
+            unsigned char largo = 0;
+            if (usadosNombres + 256 > capacidadNombres) {
+                capacidadNombres *= 2;
+                char* mas = (char*)realloc(nombres, capacidadNombres);
+                if (mas == NULL) {
+                    valido = false;
+                    break;
+                }
+                nombres = mas;
+            }
+            char* nombre = nombres + usadosNombres;
+            valido = archivo.leer(&tipo, 1) && archivo.leer(&largo, 1) && archivo.leer(nombre, largo);
+            if (!valido) break;
+            nombre[largo] = '\0';
+            inicioNombre[k] = (unsigned)usadosNombres;
+            usadosNombres += (size_t)largo + 1;
+            tipos[k] = (char)tipo;
+            origen[k] = (int)k;
+            
+            if (RegistroTipos::buscar((char)tipo) == NULL) {
+                printf("[Importador] Error: tipo de sensor desconocido '%c'\n", tipo);
+                avisado = true;
+                valido = false;
+                break;
+            }
+            sensores[k] = sistema.buscarSensor(nombre);
+            if (sensores[k] != NULL) {
+                if (sensores[k]->obtenerTipo() != (char)tipo) {
+                    printf("[Importador] Error: %s es de tipo '%c' y el archivo dice '%c'\n",
+                           nombre, sensores[k]->obtenerTipo(), tipo);
+                    avisado = true;
+                    valido = false;
+                }
+                continue;
+            }
+            
+            // Nuevo: si el mismo ID ya salio antes en el archivo, uso esa entrada
+            unsigned hash = hashIdSensor(nombre);
+            size_t c = hash & (capacidadNuevos - 1);
+            while (nuevos[c].entrada != 0 &&
+                   (nuevos[c].hash != hash || strcmp(nombres + inicioNombre[nuevos[c].entrada - 1], nombre) != 0)) {
+                c = (c + 1) & (capacidadNuevos - 1);
+            }
+            if (nuevos[c].entrada == 0) {
+                nuevos[c].hash = hash;
+                nuevos[c].entrada = (int)k + 1;
+            } else {
+                origen[k] = nuevos[c].entrada - 1;
+                if (tipos[origen[k]] != (char)tipo) {
+                    printf("[Importador] Error: %s aparece con tipos '%c' y '%c'\n", nombre, tipos[origen[k]], tipo);
+                    avisado = true;
+                    valido = false;
+                }
+            }
+        }
+        
+        // 2) Ya todo es valido: creo los que faltan
+        for (unsigned k = 0; k < cantidad && valido; k++) {
+            if (sensores[k] != NULL) continue;
+            if (origen[k] == (int)k) {
+                sensores[k] = crearSensor(tipos[k], nombres + inicioNombre[k]);
+                sistema.agregarSensor(sensores[k]);
+            } else {
+                sensores[k] = sensores[origen[k]];
+            }
+        }
+        free(nombres);
+        free(nuevos);
+        free(inicioNombre);
+        free(origen);
+        
+        // Bloques
+        long long cargadas = 0;
+        unsigned char* columnas = NULL;
+        size_t capacidadColumnas = 0;
+        double* valores = (double*)malloc(sizeof(double) * FILAS_POR_BLOQUE);
+        unsigned encabezado[6];
+        while (valido && archivo.leer(encabezado, sizeof(encabezado))) {
+            if (encabezado[0] != MAGIA_BLOQUE || encabezado[1] > (unsigned)FILAS_POR_BLOQUE) {
+                valido = false;
+                break;
+            }
+            size_t bytesColumnas = (size_t)encabezado[3] + encabezado[4] + encabezado[5];
+            if (bytesColumnas > capacidadColumnas) {
+                unsigned char* mas = (unsigned char*)realloc(columnas, bytesColumnas);
+                if (mas == NULL) {
+                    valido = false;
+                    break;
+                }
+                columnas = mas;
+                capacidadColumnas = bytesColumnas;
+            }
+            if (!archivo.leer(columnas, bytesColumnas)) {
+                valido = false;
+                break;
+            }
+            
+            LectorBytes corridas(columnas, encabezado[3]);
+            LectorBytes tiempos(columnas + encabezado[3], encabezado[4]);
+            LectorBytes lectorValores(columnas + encabezado[3] + encabezado[4], encabezado[5]);
+            for (unsigned c = 0; c < encabezado[2] && valido; c++) {
+                unsigned long long k = corridas.leerVarint();
+                char tipo = (char)corridas.leerByte();
+                unsigned long long n = corridas.leerVarint();
+                if (k >= cantidad || n > (unsigned long long)FILAS_POR_BLOQUE || tipo != tipos[k]) {
+                    valido = false;
+                    break;
+                }
+                
+                // La secuencia se valida pero no se guarda: los historiales no tienen hora
+                tiempos.leerVarint();
+                unsigned long long pares = tiempos.leerVarint();
+                for (unsigned long long p = 0; p < pares; p++) {
+                    tiempos.leerVarint();
+                    tiempos.leerVarint();
+                }
+                
+                decodificarValores(lectorValores, valores, (int)n, esTipoEntero(tipo));
+                if (corridas.error || tiempos.error || lectorValores.error) {
+                    valido = false;
+                    break;
+                }
+                sensores[k]->restaurarLote(valores, (int)n);
+                cargadas += (long long)n;
+            }
+        }
+        
+        free(valores);
+        free(columnas);
+        free(sensores);
+        free(tipos);
+        close(fd);
+        if (!valido) {
+            if (avisado) return -1;
+            printf("[Importador] Error: %s esta danado (se cargaron %lld lecturas)\n", ruta, cargadas);
+            return -1;
+        }
+        BITACORA("[Importador] %u sensores, %lld lecturas cargadas desde %s\n", cantidad, cargadas, ruta);
+        return cargadas;
+    }
+};
+
+#endif // EXPORTADOR_COLUMNAR_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef HISTOGRAMA_LATENCIA_H
+#define HISTOGRAMA_LATENCIA_H
+
+#include <cstring>  // Para memset (C puro, sin STL)
+
+/**
+ * @brief Histograma de latencias estilo HDR (log-lineal)
+ * 
+ * Los valores menores a 32 ns se guardan exactos; arriba de eso cada
+ * potencia de dos se parte en 16 cubetas, asi que el error relativo de
+ * cualquier percentil es menor al 6.25%. Registrar un valor es solo
+ * calcular un indice y sumar uno, sin pedir memoria.
+ * 
+ * Un solo hilo escribe cada histograma. Los campos se leen y escriben
+ * con atomicos relajados (en x86 son los mismos mov de siempre), asi que
+ * otro hilo puede combinarlo mientras el duenio sigue registrando sin
+ * que sea una carrera; el resultado es una foto aproximada.
+ */
+class HistogramaLatencia {
+public:
+    static const int BITS_SUB = 4;                           // 16 cubetas por potencia de dos
+    static const int SUBCUBETAS = 1 << BITS_SUB;
+    static const int EXACTOS = SUBCUBETAS * 2;               // Valores 0..31 sin redondeo
+    static const int CUBETAS = EXACTOS + (63 - BITS_SUB) * SUBCUBETAS;
+
+private:
+    long long cuentas[CUBETAS];  // Cuantos valores cayeron en cada cubeta
+    long long total;             // Cuantos valores he registrado
+    long long suma;              // Suma de todos los valores (para el promedio)
+    long long maximo;            // Valor mas grande visto
+    
+    /**
+     * @brief Calcula en que cubeta cae un valor
+     * @param valor Valor no negativo
+     * @return Indice de la cubeta
+     */
+    static int indiceDe(long long valor) {
+        if (valor < EXACTOS) return (int)valor;
+        int bitAlto = 63 - __builtin_clzll((unsigned long long)valor);
+        int corrimiento = bitAlto - BITS_SUB;
+        int sub = (int)((valor >> corrimiento) & (SUBCUBETAS - 1));
+        return EXACTOS + (bitAlto - (BITS_SUB + 1)) * SUBCUBETAS + sub;
+    }
+    
+    /**
+     * @brief Lee un campo que otro hilo puede estar escribiendo
+     * @param campo Campo del histograma
+     * @return Su valor
+     */
+    static long long leer(const long long& campo) {
+        return __atomic_load_n(&campo, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Suma a un campo (solo lo llama el hilo que escribe este histograma)
+     * 
+     * Leer y guardar por separado basta porque hay un solo escritor; no
+     * necesito una suma atomica con candado de bus.
+     * 
+     * @param campo Campo del histograma
+     * @param cantidad Cuanto sumo
+     */
+    static void incrementar(long long& campo, long long cantidad) {
+        __atomic_store_n(&campo, __atomic_load_n(&campo, __ATOMIC_RELAXED) + cantidad, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Valor representativo (punto medio) de una cubeta
+     * @param indice Indice de la cubeta
+     * @return Valor aproximado
+     */
+    static long long valorDe(int indice) {
+        if (indice < EXACTOS) return indice;
+        int k = indice - EXACTOS;
+        int bitAlto = k / SUBCUBETAS + BITS_SUB + 1;
+        int sub = k % SUBCUBETAS;
+        long long ancho = 1LL << (bitAlto - BITS_SUB);
+        return (1LL << bitAlto) + sub * ancho + ancho / 2;
+    }
+
+public:
+    /**
+     * @brief Constructor que crea un histograma vacio
+     */
+    HistogramaLatencia() {
+        reiniciar();
+    }
+    
+    /**
+     * @brief Borra todos los valores registrados
+     */
+    void reiniciar() {
+        memset(cuentas, 0, sizeof(cuentas));
+        total = 0;
+        suma = 0;
+        maximo = 0;
+    }
+    
+    /**
+     * @brief Registra un valor (normalmente nanosegundos o ciclos)
+     * @param valor El valor medido; los negativos cuentan como cero
+     */
+    void registrar(long long valor) {
+        if (valor < 0) valor = 0;
+        incrementar(cuentas[indiceDe(valor)], 1);
+        incrementar(total, 1);
+        incrementar(suma, valor);
+        if (valor > leer(maximo)) __atomic_store_n(&maximo, valor, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Suma los valores de otro histograma a este
+     * @param otro Histograma a combinar
+     */
+    void combinar(const HistogramaLatencia& otro) {
+        for (int i = 0; i < CUBETAS; i++) {
+            incrementar(cuentas[i], leer(otro.cuentas[i]));
+        }
+        incrementar(total, leer(otro.total));
+        incrementar(suma, leer(otro.suma));
+        long long otroMaximo = leer(otro.maximo);
+        if (otroMaximo > leer(maximo)) __atomic_store_n(&maximo, otroMaximo, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Calcula un percentil aproximado
+     * @param porcentaje Percentil deseado entre 0 y 100 (ej: 99.9)
+     * @return Valor del percentil, 0 si no hay datos
+     */
+    long long percentil(double porcentaje) const {
+        if (total == 0) return 0;
+        long long objetivo = (long long)(total * porcentaje / 100.0 + 0.5);
+        if (objetivo < 1) objetivo = 1;
+        if (objetivo > total) objetivo = total;
+        
+        long long acumulado = 0;
+        for (int i = 0; i < CUBETAS; i++) {
+            acumulado += cuentas[i];
+            if (acumulado >= objetivo) {
+                long long valor = valorDe(i);
+                return valor > maximo ? maximo : valor;  // No reporto mas alla del maximo real
+            }
+        }
+        return maximo;
+    }
+    
+    /**
+     * @brief Cantidad de valores registrados
+     * @return Total de muestras
+     */
+    long long obtenerTotal() const {
+        return total;
+    }
+    
+    /**
+     * @brief Valor mas grande registrado
+     * @return Maximo
+     */
+    long long obtenerMaximo() const {
+        return maximo;
+    }
+    
+    /**
+     * @brief Promedio de los valores registrados
+     * @return Promedio, 0 si no hay datos
+     */
+    double obtenerPromedio() const {
+        return total == 0 ? 0.0 : (double)suma / total;
+    }
+};
+
+#endif // HISTOGRAMA_LATENCIA_H
\ No newline at end of file
@@ -3,8 +3,79 @@
 #define LISTA_GESTION_H
 
 #include "SensorBase.h"
-#include <cstdio>   // Para printf (C puro, sin STL)
-#include <cstring>  // Para strcmp (C puro)
+#include "RegistroTipos.h"
+#include <cstdio>     // Para printf (C puro, sin STL)
+#include <cstdlib>    // Para malloc, free
+#include <cstring>    // Para strcmp (C puro)
+#include <new>        // Para construir sensores dentro de una arena
+#include <fcntl.h>    // Para open
+#include <unistd.h>   // Para read, close
+#include <sys/stat.h> // Para fstat
+#include <sys/mman.h> // Para madvise
+#include "Bitacora.h"
+#include "Metricas.h"
+#include "ContadorMemoria.h"
+#include "Reloj.h"
+
+/**
+ * @brief Bloque de memoria donde se construyen los sensores de un manifiesto
+ * 
+ * Los nodos y sensores de una carga masiva van seguidos en un solo
+ * bloque: una asignacion para toda la carga. El bloque se devuelve
+ * cuando se destruye el ultimo sensor que vive en el.
+ */
+struct ArenaSensores {
+    ArenaSensores* siguiente;  // Otras arenas de la misma lista de gestion
+    size_t bytes;              // Tamanio total del bloque (con este encabezado)
+    size_t usados;             // Bytes ya entregados
+    int vivos;                 // Sensores construidos aqui que siguen vivos
+    
+    /** Alineacion de cada objeto dentro de la arena */
+    static const size_t ALINEACION = 16;
+    
+    /**
+     * @brief Redondea un tamanio a la alineacion de la arena
+     * @param bytes Tamanio del objeto
+     * @return Tamanio redondeado
+     */
+    static size_t redondear(size_t bytes) {
+        return (bytes + ALINEACION - 1) & ~(ALINEACION - 1);
+    }
+    
+    /**
+     * @brief Crea una arena con espacio para cierta cantidad de bytes
+     * @param espacio Bytes para objetos (ya redondeados)
+     * @return La arena nueva
+     */
+    static ArenaSensores* crear(size_t espacio) {
+        size_t total = redondear(sizeof(ArenaSensores)) + espacio;
+        ArenaSensores* arena = (ArenaSensores*)ContadorMemoria::pedir(total);
+        
+        // En cargas grandes casi todo el tiempo se va en fallos de pagina;
+        // con paginas de 2 MB son 512 veces menos
+        const size_t paginaGrande = (size_t)2 << 20;
+        size_t desde = ((size_t)arena + paginaGrande - 1) & ~(paginaGrande - 1);
+        size_t hasta = ((size_t)arena + total) & ~(paginaGrande - 1);
+        if (hasta > desde) madvise((void*)desde, hasta - desde, MADV_HUGEPAGE);
+        
+        arena->siguiente = NULL;
+        arena->bytes = total;
+        arena->usados = redondear(sizeof(ArenaSensores));
+        arena->vivos = 0;
+        return arena;
+    }
+    
+    /**
+     * @brief Entrega el siguiente pedazo de la arena (debe caber)
+     * @param tamanio Bytes del objeto
+     * @return Memoria alineada para el objeto
+     */
+    void* tomar(size_t tamanio) {
+        void* p = (char*)this + usados;
+        usados += redondear(tamanio);
+        return p;
+    }
+};
 
 /**
  * @brief Estructura de nodo para la lista de gestion
@@ -14,12 +85,86 @@
 struct NodoGestion {
     SensorBase* sensor;         // Apuntador a cualquier tipo de sensor
     NodoGestion* siguiente;     // Apuntador al siguiente nodo
+    ArenaSensores* arena;       // Arena del nodo y su sensor, NULL si se pidieron sueltos
     
     /**
      * @brief Constructor del nodo
      * @param s Puntero al sensor que quiero guardar
      */
-    NodoGestion(SensorBase* s) : sensor(s), siguiente(NULL) {}
+    NodoGestion(SensorBase* s) : sensor(s), siguiente(NULL), arena(NULL) {}
+    
+    /**
+     * @brief Pido la memoria del nodo a traves del contador global
+     * @param bytes Tamanio que pide el compilador
+     * @return Memoria para el nodo
+     */
+    static void* operator new(size_t bytes) {
+        return ContadorMemoria::pedir(bytes);
+    }
+    
+    /**
+     * @brief Devuelvo la memoria del nodo al contador global
+     * @param p Memoria del nodo
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void operator delete(void* p, size_t bytes) {
+        ContadorMemoria::devolver(p, bytes);
+    }
+};
+
+/**
+ * @brief Hash FNV-1a del ID de un sensor
+ * @param id Identificador del sensor
+ * @return Hash de 32 bits
+ */
+inline unsigned hashIdSensor(const char* id) {
+    unsigned hash = 2166136261u;
+    while (*id != '\0') {
+        hash ^= (unsigned char)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Casilla del indice por ID (tabla hash con sondeo lineal)
+ */
+struct EntradaIndice {
+    unsigned hash;       // Hash del ID (para no comparar cadenas de mas)
+    SensorBase* sensor;  // NULL si la casilla esta libre
+};
+
+/**
+ * @brief Un renglon valido de un manifiesto de sensores
+ */
+struct EntradaManifiesto {
+    const char* id;          // ID dentro del texto del archivo (ya terminado en '\0')
+    unsigned hash;           // hashIdSensor(id)
+    char tipo;               // Codigo registrado; 0 si el ID ya habia salido en el manifiesto
+    bool huboBaja;           // Se borro un sensor con este ID y otro tipo
+    SensorBase* registrado;  // Sensor que ya existe con este ID, NULL si hay que crearlo
+};
+
+/**
+ * @brief Casilla de la tabla temporal de IDs de un manifiesto
+ */
+struct CasillaManifiesto {
+    unsigned hash;  // Hash del ID (para no ir a la entrada de mas)
+    int entrada;    // Posicion de la entrada + 1, 0 si la casilla esta libre
+};
+
+/**
+ * @brief Como libera la lista de gestion su memoria al destruirse
+ * 
+ * En bloque, los sensores de un manifiesto no se recorren: todo lo suyo
+ * (objeto, nombre, historial y detector) vive en arenas del registro.
+ * Eso deja de valer si a uno se le saca el historial de la arena con
+ * usarArenaHistorial(NULL); para eso hay que cerrar en detalle.
+ */
+enum ModoCierre {
+    CIERRE_DETALLADO,  // Cada sensor y cada bloque de historial, uno por uno
+    CIERRE_EN_BLOQUE,  // Solo los sensores sueltos; arenas y bloques se sueltan por trozos
+    CIERRE_SALIDA      // No libera ni descuenta nada: el proceso va a terminar (no usar con ASan)
 };
 
 /**
@@ -30,103 +175,789 @@ struct NodoGestion {
 class ListaGestion {
 private:
     NodoGestion* cabeza;  // Primer nodo de la lista
+    NodoGestion* cola;    // Ultimo nodo (para agregar sin recorrer toda la lista)
     int tamanio;          // Cantidad de sensores registrados
+    ColaSucios sucios;    // Sensores con lecturas nuevas desde el ultimo procesamiento
+    EntradaIndice* indice;  // Tabla hash por ID para buscarSensor
+    int capacidadIndice;    // Casillas de la tabla (potencia de dos, 0 si no hay)
+    ArenaSensores* arenas;  // Arenas de las cargas por manifiesto
+    int sueltos;            // Sensores registrados con agregarSensor (fuera de las arenas)
+    CuentaBytes memoria;    // Lo reservado a nombre de este registro (antes que bloquesHistorial)
+    ArenaBloques bloquesHistorial;  // Bloques de los historiales y detectores de mis sensores
+    ModoCierre modoCierre;          // Que hace el destructor
     
-public:
     /**
-     * @brief Constructor que crea una lista vacia
+     * @brief Pone un sensor en el indice (debe haber espacio)
+     * 
+     * Si ya hay otro sensor con el mismo ID me quedo con el primero, que
+     * es el que encontraba la busqueda lineal.
+     * 
+     * @param hash Hash del ID
+     * @param sensor Sensor a indexar
      */
-    ListaGestion() : cabeza(NULL), tamanio(0) {
-        printf("[Sistema] Lista de gestion inicializada.\n");  // Sin STL
+    void colocarEnIndice(unsigned hash, SensorBase* sensor) {
+        unsigned mascara = (unsigned)capacidadIndice - 1;
+        unsigned i = hash & mascara;
+        while (indice[i].sensor != NULL) {
+            if (indice[i].hash == hash &&
+                strcmp(indice[i].sensor->obtenerNombre(), sensor->obtenerNombre()) == 0) {
+                return;
+            }
+            i = (i + 1) & mascara;
+        }
+        indice[i].hash = hash;
+        indice[i].sensor = sensor;
     }
     
     /**
-     * @brief Destructor que libera todos los sensores
+     * @brief Agranda el indice y vuelve a colocar todos los sensores
+     * @param casillas Casillas minimas que quiero
      */
-    ~ListaGestion() {
-        printf("\n--- Liberacion de Memoria en Cascada ---\n");  // Sin STL
+    void crecerIndice(int casillas) {
+        int nueva = 16;
+        while (nueva < casillas) nueva *= 2;
+        if (nueva <= capacidadIndice) return;
+        
+        ContadorMemoria::devolver(indice, sizeof(EntradaIndice) * capacidadIndice);
+        memoria.restar((long long)(sizeof(EntradaIndice) * capacidadIndice));
+        indice = (EntradaIndice*)ContadorMemoria::pedir(sizeof(EntradaIndice) * nueva);
+        memoria.sumar((long long)(sizeof(EntradaIndice) * nueva));
+        capacidadIndice = nueva;
+        recolocarIndice();
+    }
+    
+    /**
+     * @brief Vacia el indice y vuelve a colocar todos los sensores
+     */
+    void recolocarIndice() {
+        memset(indice, 0, sizeof(EntradaIndice) * capacidadIndice);
         
-        // Recorro todos los nodos y los voy borrando
+        // Recoloco en orden de registro para respetar el "primero gana"
         NodoGestion* actual = cabeza;
         while (actual != NULL) {
-            NodoGestion* siguiente = actual->siguiente;
-            
-            printf("[Destructor General] Liberando Nodo: %s\n", 
-                   actual->sensor->obtenerNombre());
+            colocarEnIndice(hashIdSensor(actual->sensor->obtenerNombre()), actual->sensor);
+            actual = actual->siguiente;
+        }
+    }
+    
+    /**
+     * @brief Saca un sensor del indice sin dejar huecos en las cadenas
+     * 
+     * Despues de vaciar la casilla recorro hacia atras las que quedarian
+     * inalcanzables por el sondeo lineal (borrado por corrimiento).
+     * 
+     * @param sensor Sensor a sacar (si no esta indexado no hace nada)
+     */
+    void quitarDeIndice(SensorBase* sensor) {
+        if (capacidadIndice == 0) return;
+        unsigned mascara = (unsigned)capacidadIndice - 1;
+        unsigned hueco = hashIdSensor(sensor->obtenerNombre()) & mascara;
+        while (indice[hueco].sensor != sensor) {
+            if (indice[hueco].sensor == NULL) return;
+            hueco = (hueco + 1) & mascara;
+        }
+        unsigned j = hueco;
+        for (;;) {
+            j = (j + 1) & mascara;
+            if (indice[j].sensor == NULL) break;
+            unsigned ideal = indice[j].hash & mascara;
             
-            // Borro el sensor (esto llamara al destructor correcto por polimorfismo)
-            delete actual->sensor;
+            // Si su casilla ideal esta entre el hueco y j, j sigue alcanzable
+            bool alcanzable = hueco <= j ? (hueco < ideal && ideal <= j) : (hueco < ideal || ideal <= j);
+            if (!alcanzable) {
+                indice[hueco] = indice[j];
+                hueco = j;
+            }
+        }
+        indice[hueco].hash = 0;
+        indice[hueco].sensor = NULL;
+    }
+    
+    /**
+     * @brief Engancha un nodo al final y lo conecta a la cola de sucios
+     * @param nodo Nodo nuevo (no toca el indice)
+     */
+    void enlazarNodo(NodoGestion* nodo) {
+        if (cabeza == NULL) {
+            cabeza = nodo;
+        } else {
+            cola->siguiente = nodo;
+        }
+        cola = nodo;
+        nodo->sensor->conectarColaSucios(&sucios);
+        nodo->sensor->usarArenaHistorial(&bloquesHistorial);
+        nodo->sensor->usarArenaDetector(&bloquesHistorial);
+        tamanio++;
+    }
+    
+    /**
+     * @brief Destruye un nodo ya desenganchado y su sensor
+     * 
+     * Si viven en una arena solo llamo a los destructores; la arena se
+     * devuelve entera cuando se va su ultimo sensor.
+     * 
+     * @param nodo Nodo a destruir
+     */
+    void destruirNodo(NodoGestion* nodo) {
+        ArenaSensores* arena = nodo->arena;
+        if (arena == NULL) {
+            memoria.restar((long long)bytesSuelto(nodo->sensor));
+            delete nodo->sensor;  // Llama al destructor correcto por polimorfismo
+            delete nodo;
+            sueltos--;
+            return;
+        }
+        nodo->sensor->~SensorBase();
+        nodo->~NodoGestion();
+        if (--arena->vivos > 0) return;
+        
+        ArenaSensores** enlace = &arenas;
+        while (*enlace != arena) enlace = &(*enlace)->siguiente;
+        *enlace = arena->siguiente;
+        soltarArena(arena);
+    }
+    
+    /**
+     * @brief Devuelve una arena de sensores y la descuenta
+     * @param arena Arena ya desenganchada
+     */
+    void soltarArena(ArenaSensores* arena) {
+        memoria.restar((long long)arena->bytes);
+        ContadorMemoria::devolver(arena, arena->bytes);
+    }
+    
+    /**
+     * @brief Bytes que anoto por un sensor de agregarSensor y su nodo
+     * 
+     * El objeto lo creo quien llama; lo cuento con el tamanio de su tipo
+     * registrado. Historial y detector se cuentan en los trozos de
+     * bloquesHistorial.
+     * 
+     * @param sensor Sensor suelto
+     * @return Bytes del objeto y del nodo
+     */
+    static size_t bytesSuelto(const SensorBase* sensor) {
+        size_t objeto = bytesDeTipo(sensor->obtenerTipo());
+        return sizeof(NodoGestion) + (objeto != 0 ? objeto : sizeof(SensorBase));
+    }
+    
+    /**
+     * @brief Bytes que ocupa un sensor del tipo dado
+     * @param tipo Codigo del tipo (ver RegistroTipos)
+     * @return Tamanio del objeto, 0 si el tipo no esta registrado
+     */
+    static size_t bytesDeTipo(char tipo) {
+        const TipoSensor* registrado = RegistroTipos::buscar(tipo);
+        return registrado != NULL ? registrado->bytes : 0;
+    }
+    
+    /**
+     * @brief Construye un sensor en memoria ya reservada
+     * @param memoria Espacio de al menos bytesDeTipo(tipo)
+     * @param tipo Codigo de un tipo registrado
+     * @param id Identificador del sensor
+     * @return El sensor construido
+     */
+    static SensorBase* construirEn(void* memoria, char tipo, const char* id) {
+        return RegistroTipos::buscar(tipo)->construirEn(memoria, id);
+    }
+    
+    /** Cuantas entradas adelante pido a la cache la casilla de la tabla */
+    static const int ADELANTO = 16;
+    
+    /**
+     * @brief Tabla temporal con los IDs de un manifiesto
+     */
+    struct TablaManifiesto {
+        EntradaManifiesto* entradas;  // Renglones validos en orden del archivo
+        int cantidad;
+        CasillaManifiesto* casillas;  // Sondeo lineal por hash
+        unsigned mascara;
+        
+        /**
+         * @brief Busca una entrada por ID
+         * @param id Identificador
+         * @param hash hashIdSensor(id)
+         * @return La entrada, NULL si el ID no esta en el manifiesto
+         */
+        EntradaManifiesto* buscar(const char* id, unsigned hash) const {
+            unsigned i = hash & mascara;
+            while (casillas[i].entrada != 0) {
+                if (casillas[i].hash == hash) {
+                    EntradaManifiesto* e = &entradas[casillas[i].entrada - 1];
+                    if (strcmp(e->id, id) == 0) return e;
+                }
+                i = (i + 1) & mascara;
+            }
+            return NULL;
+        }
+        
+        /**
+         * @brief Mete una entrada en la tabla si su ID no estaba
+         * @param k Posicion de la entrada
+         * @return false si el ID ya estaba (la entrada es repetida)
+         */
+        bool insertar(int k) {
+            const EntradaManifiesto& e = entradas[k];
+            unsigned i = e.hash & mascara;
+            while (casillas[i].entrada != 0) {
+                if (casillas[i].hash == e.hash && strcmp(entradas[casillas[i].entrada - 1].id, e.id) == 0) {
+                    return false;
+                }
+                i = (i + 1) & mascara;
+            }
+            casillas[i].hash = e.hash;
+            casillas[i].entrada = k + 1;
+            return true;
+        }
+        
+        /**
+         * @brief Pide a la cache la casilla de un hash que voy a usar pronto
+         * @param hash Hash del ID
+         */
+        void adelantar(unsigned hash) const {
+            __builtin_prefetch(&casillas[hash & mascara]);
+        }
+    };
+    
+    /**
+     * @brief Dice si un sensor ya no corresponde al manifiesto
+     * @param sensor Sensor registrado
+     * @param contexto Apuntador a la TablaManifiesto
+     * @return true si su ID no esta o cambio de tipo
+     */
+    static bool sobraEnManifiesto(const SensorBase* sensor, void* contexto) {
+        const TablaManifiesto* tabla = (const TablaManifiesto*)contexto;
+        EntradaManifiesto* e = tabla->buscar(sensor->obtenerNombre(), hashIdSensor(sensor->obtenerNombre()));
+        return e == NULL || e->tipo != sensor->obtenerTipo();
+    }
+    
+    /**
+     * @brief Compara contra un sensor en particular
+     * @param sensor Sensor de la cola
+     * @param contexto El sensor buscado
+     * @return true si es el mismo
+     */
+    static bool esEsteSensor(const SensorBase* sensor, void* contexto) {
+        return sensor == contexto;
+    }
+    
+    /**
+     * @brief Lee un archivo completo de un solo golpe
+     * @param ruta Archivo a leer
+     * @param largo Salida: bytes leidos
+     * @return Texto terminado en '\0' (liberar con free), NULL si hubo error
+     */
+    static char* leerArchivo(const char* ruta, size_t& largo) {
+        int fd = open(ruta, O_RDONLY);
+        if (fd < 0) return NULL;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            return NULL;
+        }
+        char* texto = (char*)malloc((size_t)info.st_size + 1);
+        largo = 0;
+        while (largo < (size_t)info.st_size) {
+            ssize_t n = read(fd, texto + largo, (size_t)info.st_size - largo);
+            if (n <= 0) break;
+            largo += (size_t)n;
+        }
+        close(fd);
+        texto[largo] = '\0';
+        return texto;
+    }
+    
+    /**
+     * @brief Separa el texto de un manifiesto en renglones "ID TIPO"
+     * 
+     * Corta el texto en su lugar (pone '\0' al final de cada ID). Se
+     * saltan renglones vacios y comentarios con '#'.
+     * 
+     * @param texto Contenido del archivo (se modifica)
+     * @param largo Bytes del texto
+     * @param tabla Salida: entradas en orden del archivo (liberar con free)
+     * @return Renglones que no se entendieron
+     */
+    static int separarManifiesto(char* texto, size_t largo, TablaManifiesto& tabla) {
+        // Cota de renglones para pedir la memoria una sola vez
+        int renglones = 1;
+        for (size_t i = 0; i < largo; i++) renglones += texto[i] == '\n';
+        tabla.entradas = (EntradaManifiesto*)malloc(sizeof(EntradaManifiesto) * renglones);
+        tabla.cantidad = 0;
+        tabla.casillas = NULL;
+        tabla.mascara = 0;
+        int invalidas = 0;
+        
+        char* p = texto;
+        char* fin = texto + largo;
+        while (p < fin) {
+            while (p < fin && (*p == ' ' || *p == '\t')) p++;
+            char* id = p;
+            while (p < fin && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+            char* finId = p;
+            while (p < fin && (*p == ' ' || *p == '\t')) p++;
+            char* tipo = p;
+            while (p < fin && *p != '\n') p++;
+            char* finRenglon = p;
+            if (p < fin) p++;  // Salto el '\n'
             
-            // Borro el nodo de la lista
-            delete actual;
+            if (finId == id || *id == '#') continue;  // Vacio o comentario
+            while (finRenglon > tipo && (finRenglon[-1] == '\r' || finRenglon[-1] == ' ')) finRenglon--;
+            if (finRenglon - tipo != 1 || bytesDeTipo(*tipo) == 0 || finId - id > 49) {
+                invalidas++;
+                continue;
+            }
+            *finId = '\0';
             
+            EntradaManifiesto& e = tabla.entradas[tabla.cantidad++];
+            e.id = id;
+            e.hash = hashIdSensor(id);
+            e.tipo = *tipo;
+            e.huboBaja = false;
+            e.registrado = NULL;
+        }
+        return invalidas;
+    }
+    
+    /**
+     * @brief Llena la tabla por ID de un manifiesto ya separado
+     * 
+     * Pido cada casilla a la cache unas entradas antes de usarla. Un ID
+     * repetido en el manifiesto cuenta una sola vez.
+     * 
+     * @param tabla Manifiesto separado (las entradas repetidas quedan con tipo 0)
+     * @return Entradas repetidas
+     */
+    static int indexarManifiesto(TablaManifiesto& tabla) {
+        int casillas = 16;
+        while (casillas < tabla.cantidad * 2) casillas *= 2;
+        tabla.casillas = (CasillaManifiesto*)calloc(casillas, sizeof(CasillaManifiesto));
+        tabla.mascara = (unsigned)casillas - 1;
+        int repetidos = 0;
+        for (int k = 0; k < tabla.cantidad; k++) {
+            if (k + ADELANTO < tabla.cantidad) tabla.adelantar(tabla.entradas[k + ADELANTO].hash);
+            if (!tabla.insertar(k)) {
+                tabla.entradas[k].tipo = 0;
+                repetidos++;
+            }
+        }
+        return repetidos;
+    }
+    
+    /**
+     * @brief Borra los sensores que no estan en el manifiesto o cambiaron de tipo
+     * 
+     * Los que se quedan anotan su sensor en la entrada del manifiesto, asi
+     * que despues ya no hay que buscarlos en el indice.
+     * 
+     * @param tabla Manifiesto ya separado
+     * @return Sensores borrados
+     */
+    int quitarAusentes(TablaManifiesto& tabla) {
+        // Primero salen de la cola de sucios (en una pasada)
+        sucios.quitarSi(sobraEnManifiesto, &tabla);
+        
+        SilencioBitacora silencio;  // Sin un renglon por sensor borrado
+        int quitados = 0;
+        NodoGestion* anterior = NULL;
+        NodoGestion* actual = cabeza;
+        NodoGestion* adelante = cabeza;  // Va ADELANTO nodos antes que actual
+        for (int i = 0; i < ADELANTO && adelante != NULL; i++) adelante = adelante->siguiente;
+        while (actual != NULL) {
+            if (adelante != NULL) {
+                tabla.adelantar(hashIdSensor(adelante->sensor->obtenerNombre()));
+                adelante = adelante->siguiente;
+            }
+            NodoGestion* siguiente = actual->siguiente;
+            SensorBase* sensor = actual->sensor;
+            EntradaManifiesto* e = tabla.buscar(sensor->obtenerNombre(), hashIdSensor(sensor->obtenerNombre()));
+            if (e != NULL && e->tipo == sensor->obtenerTipo()) {
+                if (e->registrado == NULL) e->registrado = sensor;
+                anterior = actual;
+            } else {
+                if (e != NULL) e->huboBaja = true;
+                if (anterior == NULL) {
+                    cabeza = siguiente;
+                } else {
+                    anterior->siguiente = siguiente;
+                }
+                if (actual == cola) cola = anterior;
+                tamanio--;
+                quitarDeIndice(sensor);
+                destruirNodo(actual);
+                quitados++;
+            }
             actual = siguiente;
         }
         
-        printf("Sistema cerrado. Memoria limpia.\n");
+        // Si se fue el sensor indexado de un ID repetido, el que se quedo toma su lugar
+        for (int i = 0; i < tabla.cantidad; i++) {
+            const EntradaManifiesto& e = tabla.entradas[i];
+            if (e.huboBaja && e.registrado != NULL) colocarEnIndice(e.hash, e.registrado);
+        }
+        return quitados;
     }
     
     /**
-     * @brief Agrega un nuevo sensor a la lista de gestion
-     * @param sensor Puntero al sensor que quiero agregar
+     * @brief Crea en una sola arena los sensores del manifiesto que faltan
+     * 
+     * Las entradas que ya tienen sensor registrado se saltan. Un ID que
+     * ya esta en el indice al momento de crearlo salio antes en el mismo
+     * manifiesto: cuenta como repetido y no se crea.
+     * 
+     * @param tabla Manifiesto separado
+     * @param repetidos Se le suman los IDs repetidos encontrados aqui
+     * @return Sensores creados
      */
-    void agregarSensor(SensorBase* sensor) {
-        // Creo un nuevo nodo para este sensor
-        NodoGestion* nuevoNodo = new NodoGestion(sensor);
+    int crearDesdeManifiesto(const TablaManifiesto& tabla, int& repetidos) {
+        size_t espacio = 0;
+        int porCrear = 0;
+        for (int i = 0; i < tabla.cantidad; i++) {
+            const EntradaManifiesto& e = tabla.entradas[i];
+            if (e.tipo == 0 || e.registrado != NULL) continue;
+            espacio += ArenaSensores::redondear(sizeof(NodoGestion)) +
+                       ArenaSensores::redondear(bytesDeTipo(e.tipo));
+            porCrear++;
+        }
+        if (porCrear == 0) return 0;
+        ArenaSensores* arena = ArenaSensores::crear(espacio);
+        memoria.sumar((long long)arena->bytes);
+        arena->siguiente = arenas;
+        arenas = arena;
+        reservarIndice(tamanio + porCrear);
+        unsigned mascara = (unsigned)capacidadIndice - 1;
         
-        // Si la lista esta vacia, este es el primer nodo
-        if (cabeza == NULL) {
-            cabeza = nuevoNodo;
+        // Los constructores no deben imprimir un renglon por sensor
+        SilencioBitacora silencio;
+        int creados = 0;
+        for (int i = 0; i < tabla.cantidad; i++) {
+            if (i + ADELANTO < tabla.cantidad) {
+                __builtin_prefetch(&indice[tabla.entradas[i + ADELANTO].hash & mascara], 1);
+            }
+            const EntradaManifiesto& e = tabla.entradas[i];
+            if (e.tipo == 0 || e.registrado != NULL) continue;
+            
+            // Busco la casilla: si el ID ya esta, es un repetido del manifiesto
+            unsigned c = e.hash & mascara;
+            while (indice[c].sensor != NULL &&
+                   (indice[c].hash != e.hash || strcmp(indice[c].sensor->obtenerNombre(), e.id) != 0)) {
+                c = (c + 1) & mascara;
+            }
+            if (indice[c].sensor != NULL) {
+                repetidos++;
+                continue;
+            }
+            NodoGestion* nodo = ::new (arena->tomar(sizeof(NodoGestion))) NodoGestion(NULL);
+            nodo->sensor = construirEn(arena->tomar(bytesDeTipo(e.tipo)), e.tipo, e.id);
+            nodo->arena = arena;
+            arena->vivos++;
+            enlazarNodo(nodo);
+            indice[c].hash = e.hash;
+            indice[c].sensor = nodo->sensor;
+            creados++;
+        }
+        
+        // Si todos eran repetidos la arena no se usa
+        if (creados == 0) {
+            arenas = arena->siguiente;
+            soltarArena(arena);
+        }
+        return creados;
+    }
+    
+    /**
+     * @brief Carga o recarga un manifiesto
+     * @param ruta Archivo de texto con renglones "ID TIPO"
+     * @param recargar Si borro los sensores que no estan en el manifiesto
+     * @return Sensores creados, -1 si no se pudo leer el archivo
+     */
+    int aplicarManifiesto(const char* ruta, bool recargar) {
+        long long inicio = relojNs();
+        size_t largo = 0;
+        char* texto = leerArchivo(ruta, largo);
+        if (texto == NULL) {
+            printf("[Sistema] Error: no pude leer el manifiesto %s\n", ruta);
+            return -1;
+        }
+        TablaManifiesto tabla;
+        int invalidas = separarManifiesto(texto, largo, tabla);
+        
+        // Con el registro vacio no hay nada que comparar: los repetidos
+        // del manifiesto los detecta el indice al crear
+        int repetidos = 0;
+        int quitados = 0;
+        if (recargar && tamanio > 0) {
+            repetidos = indexarManifiesto(tabla);
+            quitados = quitarAusentes(tabla);
+        } else if (tamanio > 0) {
+            for (int i = 0; i < tabla.cantidad; i++) {
+                tabla.entradas[i].registrado = buscarSensor(tabla.entradas[i].id);
+            }
+        }
+        int existentes = 0;
+        for (int i = 0; i < tabla.cantidad; i++) existentes += tabla.entradas[i].registrado != NULL;
+        int nuevos = crearDesdeManifiesto(tabla, repetidos);
+        
+        BITACORA("[Sistema] Manifiesto %s: %d sensores nuevos, %d quitados, %d ya registrados, "
+                 "%d repetidos, %d renglones invalidos (%.1f ms)\n",
+                 ruta, nuevos, quitados, existentes, repetidos, invalidas, nsAMs(relojNs() - inicio));
+        free(tabla.entradas);
+        free(tabla.casillas);
+        free(texto);
+        return nuevos;
+    }
+    
+    /**
+     * @brief Bytes del propio objeto, los nodos de gestion y el indice
+     * @return Total en bytes
+     */
+    size_t bytesEstructura() const {
+        return sizeof(*this) + (size_t)tamanio * sizeof(NodoGestion) +
+               (size_t)capacidadIndice * sizeof(EntradaIndice);
+    }
+    
+public:
+    /**
+     * @brief Constructor que crea una lista vacia
+     */
+    ListaGestion()
+        : cabeza(NULL), cola(NULL), tamanio(0), indice(NULL), capacidadIndice(0), arenas(NULL),
+          sueltos(0), modoCierre(CIERRE_EN_BLOQUE) {
+        memoria.sumar((long long)sizeof(*this));
+        bloquesHistorial.contarEn(&memoria);
+        BITACORA("[Sistema] Lista de gestion inicializada.\n");  // Sin STL
+    }
+    
+    /**
+     * @brief Destructor que libera todos los sensores segun el modo de cierre
+     */
+    ~ListaGestion() {
+        if (modoCierre == CIERRE_SALIDA) {
+            // El sistema operativo recupera todo cuando termina el proceso;
+            // el contador de memoria se queda con estos bytes como vivos
+            bloquesHistorial.abandonar();
+            BITACORA("Sistema cerrado sin liberar memoria (salida rapida).\n");
+            return;
+        }
+        BITACORA("\n--- Liberacion de Memoria en Cascada ---\n");  // Sin STL
+        BITACORA("[Destructor General] Liberando %d sensores\n", tamanio);
+        
+        if (modoCierre == CIERRE_EN_BLOQUE) {
+            // Los historiales y detectores no recorren sus bloques: se
+            // sueltan con los trozos cuando se destruye bloquesHistorial.
+            // Solo borro los sensores sueltos; a los de las arenas no les
+            // queda nada que liberar, asi que me salto sus destructores
+            bloquesHistorial.iniciarCierre();
+            NodoGestion* actual = cabeza;
+            while (sueltos > 0) {
+                NodoGestion* siguiente = actual->siguiente;
+                if (actual->arena == NULL) destruirNodo(actual);
+                actual = siguiente;
+            }
+            while (arenas != NULL) {
+                ArenaSensores* siguiente = arenas->siguiente;
+                soltarArena(arenas);
+                arenas = siguiente;
+            }
         } else {
-            // Si no, busco el final y lo agrego ahi
+            // Recorro todos los nodos y los voy borrando
             NodoGestion* actual = cabeza;
-            while (actual->siguiente != NULL) {
-                actual = actual->siguiente;
+            while (actual != NULL) {
+                NodoGestion* siguiente = actual->siguiente;
+                
+                // Borro el sensor y su nodo (o los destruyo en su arena)
+                destruirNodo(actual);
+                
+                actual = siguiente;
             }
-            actual->siguiente = nuevoNodo;
         }
+        ContadorMemoria::devolver(indice, sizeof(EntradaIndice) * capacidadIndice);
         
-        tamanio++;
-        printf("[Sistema] Sensor '%s' agregado a la lista de gestion.\n", 
+        BITACORA("Sistema cerrado. Memoria limpia.\n");
+    }
+    
+    /**
+     * @brief Elige que hace el destructor con la memoria
+     * 
+     * CIERRE_EN_BLOQUE (por defecto) y CIERRE_DETALLADO no dejan fugas;
+     * el detallado recorre cada bloque y sirve para revisar con ASan que
+     * cada pieza se libera por su camino normal. CIERRE_SALIDA es solo
+     * para cuando el proceso termina justo despues: lo abandonado
+     * (sensores, nodos, indice, trozos de historial) sigue contado como
+     * vivo en ContadorMemoria, y descontarlo costaria el mismo recorrido
+     * que se quiere evitar. Despues de ese cierre el resumen del contador
+     * ya no dice nada util.
+     * 
+     * @param modo Modo de cierre
+     */
+    void fijarModoCierre(ModoCierre modo) {
+        modoCierre = modo;
+    }
+    
+    /**
+     * @brief Agrega un nuevo sensor a la lista de gestion
+     * @param sensor Puntero al sensor que quiero agregar
+     */
+    void agregarSensor(SensorBase* sensor) {
+        // Creo un nuevo nodo para este sensor y lo engancho despues del
+        // ultimo; tambien lo conecto a mi cola de sucios para enterarme de
+        // sus lecturas nuevas
+        enlazarNodo(new NodoGestion(sensor));
+        sueltos++;
+        memoria.sumar((long long)bytesSuelto(sensor));
+        
+        // Mantengo el indice a menos de la mitad de ocupacion
+        if (tamanio * 2 > capacidadIndice) {
+            crecerIndice(tamanio * 2);  // Ya incluye al sensor nuevo
+        } else {
+            colocarEnIndice(hashIdSensor(sensor->obtenerNombre()), sensor);
+        }
+        BITACORA("[Sistema] Sensor '%s' agregado a la lista de gestion.\n", 
                sensor->obtenerNombre());
     }
     
+    /**
+     * @brief Registra de un jalon los sensores de un manifiesto
+     * 
+     * El manifiesto es texto con un renglon "ID TIPO" por sensor (TIPO
+     * es el codigo de un tipo registrado; '#' empieza un comentario). Se
+     * lee con una sola lectura, el indice se agranda una vez y todos los
+     * sensores nuevos se
+     * construyen en una sola arena. Los IDs que ya estan registrados se
+     * dejan como estan. Solo imprime un renglon de resumen.
+     * 
+     * @param ruta Archivo del manifiesto
+     * @return Sensores creados, -1 si no se pudo leer
+     */
+    int cargarManifiesto(const char* ruta) {
+        return aplicarManifiesto(ruta, false);
+    }
+    
+    /**
+     * @brief Deja el registro igual al manifiesto
+     * 
+     * Compara contra lo registrado: los sensores que ya no aparecen, o que
+     * aparecen con otro tipo, se borran (con su historial); los que faltan
+     * se crean como en cargarManifiesto; los demas no se tocan.
+     * 
+     * @param ruta Archivo del manifiesto
+     * @return Sensores creados, -1 si no se pudo leer
+     */
+    int recargarManifiesto(const char* ruta) {
+        return aplicarManifiesto(ruta, true);
+    }
+    
+    /**
+     * @brief Borra un sensor y su historial
+     * 
+     * Si habia otro sensor registrado con el mismo ID, ese pasa a ser el
+     * que encuentra buscarSensor.
+     * 
+     * @param id Identificador del sensor
+     * @return true si existia
+     */
+    bool eliminarSensor(const char* id) {
+        SensorBase* sensor = buscarSensor(id);
+        if (sensor == NULL) return false;
+        if (sensor->estaSucio()) sucios.quitarSi(esEsteSensor, sensor);
+        quitarDeIndice(sensor);
+        
+        // Busco su nodo (y el anterior) para desengancharlo
+        NodoGestion* anterior = NULL;
+        NodoGestion* nodo = cabeza;
+        while (nodo->sensor != sensor) {
+            anterior = nodo;
+            nodo = nodo->siguiente;
+        }
+        if (anterior == NULL) {
+            cabeza = nodo->siguiente;
+        } else {
+            anterior->siguiente = nodo->siguiente;
+        }
+        if (nodo == cola) cola = anterior;
+        tamanio--;
+        
+        for (NodoGestion* otro = nodo->siguiente; otro != NULL; otro = otro->siguiente) {
+            if (strcmp(otro->sensor->obtenerNombre(), sensor->obtenerNombre()) == 0) {
+                colocarEnIndice(hashIdSensor(sensor->obtenerNombre()), otro->sensor);
+                break;
+            }
+        }
+        BITACORA("[Sistema] Sensor '%s' eliminado.\n", sensor->obtenerNombre());
+        destruirNodo(nodo);
+        return true;
+    }
+    
+    /**
+     * @brief Prepara el indice para cierta cantidad de sensores
+     * 
+     * Sirve para cargas grandes: evita ir duplicando la tabla mientras
+     * se agregan los sensores.
+     * 
+     * @param sensores Cantidad de sensores que espero tener
+     */
+    void reservarIndice(int sensores) {
+        crecerIndice(sensores * 2);
+    }
+    
     /**
      * @brief Busca un sensor por su ID
      * @param id Identificador del sensor
      * @return Puntero al sensor si lo encuentra, nullptr si no
      */
     SensorBase* buscarSensor(const char* id) {
-        // Recorro la lista comparando nombres
-        NodoGestion* actual = cabeza;
-        while (actual != NULL) {
-            if (strcmp(actual->sensor->obtenerNombre(), id) == 0) {
-                return actual->sensor;  // Lo encontre
+        MEDIR_OPERACION(OP_BUSCAR_SENSOR);
+        if (capacidadIndice == 0) return NULL;
+        
+        // Sondeo desde la casilla del hash hasta encontrarlo o ver una vacia
+        unsigned hash = hashIdSensor(id);
+        unsigned mascara = (unsigned)capacidadIndice - 1;
+        unsigned i = hash & mascara;
+        while (indice[i].sensor != NULL) {
+            if (indice[i].hash == hash && strcmp(indice[i].sensor->obtenerNombre(), id) == 0) {
+                return indice[i].sensor;  // Lo encontre
             }
-            actual = actual->siguiente;
+            i = (i + 1) & mascara;
         }
         return NULL;  // No lo encontre
     }
     
     /**
-     * @brief Ejecuta el procesamiento polimorfico de todos los sensores
+     * @brief Ejecuta el procesamiento polimorfico de los sensores con lecturas nuevas
      * 
      * Aqui es donde ocurre la magia del polimorfismo: cada sensor
-     * ejecutara su propia version de procesarLectura()
+     * ejecutara su propia version de procesarLectura(). Solo visito los
+     * sensores de la cola de sucios, asi que el costo depende de cuantos
+     * sensores recibieron datos y no del total de sensores registrados.
+     * 
+     * @return Cantidad de sensores procesados en esta pasada
      */
-    void procesarTodos() {
-        printf("\n--- Ejecutando Polimorfismo ---\n");  // Sin STL
+    int procesarTodos() {
+        MEDIR_OPERACION(OP_PROCESAR_TODOS);
+        BITACORA("\n--- Ejecutando Polimorfismo ---\n");  // Sin STL
         
-        // Recorro todos los sensores
-        NodoGestion* actual = cabeza;
+        if (sucios.cantidad == 0) {
+            BITACORA("[Sistema] Ningun sensor tiene lecturas nuevas.\n");
+            return 0;
+        }
+        
+        // Recorro solo los sensores pendientes, en el orden en que se ensuciaron
+        int procesados = 0;
+        SensorBase* actual = sucios.extraer();
         while (actual != NULL) {
+            // Lo limpio antes de procesar para que una lectura nueva lo vuelva a encolar
+            actual->limpiarSucio();
+            
             // Llamo al metodo procesarLectura() usando el puntero de la clase base
             // Pero gracias al polimorfismo, se ejecutara el metodo correcto
-            // segun el tipo real del sensor (Temperatura o Presion)
-            actual->sensor->procesarLectura();
+            // segun el tipo real del sensor (cualquiera de los registrados)
+            actual->procesarLectura();
+            procesados++;
             
-            actual = actual->siguiente;
+            actual = sucios.extraer();
         }
+        return procesados;
     }
     
     /**
@@ -155,6 +986,118 @@ public:
     int obtenerTamanio() const {
         return tamanio;
     }
+    
+    /**
+     * @brief Visita cada sensor en orden de registro
+     * @param visita Funcion a llamar con cada sensor
+     * @param contexto Dato extra que se pasa tal cual a la funcion
+     */
+    void paraCadaSensor(void (*visita)(SensorBase*, void*), void* contexto) const {
+        NodoGestion* actual = cabeza;
+        while (actual != NULL) {
+            visita(actual->sensor, contexto);
+            actual = actual->siguiente;
+        }
+    }
+    
+    /**
+     * @brief Muestra cuantas lecturas guardan los historiales de la flota
+     */
+    void imprimirLongitudes() const {
+        long long totalLecturas = 0;
+        int maximo = 0;
+        const char* masLargo = "-";
+        
+        NodoGestion* actual = cabeza;
+        while (actual != NULL) {
+            int lecturas = actual->sensor->obtenerCantidadLecturas();
+            totalLecturas += lecturas;
+            if (lecturas > maximo) {
+                maximo = lecturas;
+                masLargo = actual->sensor->obtenerNombre();
+            }
+            actual = actual->siguiente;
+        }
+        
+        printf("Sensores: %d, pendientes de procesar: %d\n", tamanio, sucios.cantidad);
+        printf("Lecturas en historiales: %lld (promedio %.1f por sensor, maximo %d en %s)\n",
+               totalLecturas, tamanio == 0 ? 0.0 : (double)totalLecturas / tamanio, maximo, masLargo);
+    }
+    
+    /**
+     * @brief Bytes que ocupa toda la flota (sensores, historiales, nodos e indice)
+     * @return Total en bytes
+     */
+    size_t obtenerBytesFlota() const {
+        size_t total = bytesEstructura();
+        NodoGestion* actual = cabeza;
+        while (actual != NULL) {
+            total += actual->sensor->obtenerBytesPropios();
+            actual = actual->siguiente;
+        }
+        return total;
+    }
+    
+    /**
+     * @brief Memoria reservada a nombre de este registro
+     * 
+     * A diferencia de obtenerBytesFlota (lo que ocupan los datos) cuenta
+     * lo que el registro tiene pedido: objetos y nodos sueltos, arenas de
+     * manifiesto, indice y trozos enteros de historiales y detectores.
+     * Se lleva en cada reserva, asi que no recorre la flota.
+     * 
+     * @return Bytes vivos
+     */
+    long long obtenerBytesReservados() const {
+        return memoria.vivos;
+    }
+    
+    /**
+     * @brief Mayor memoria que ha tenido reservada este registro
+     * @return Pico en bytes
+     */
+    long long obtenerPicoBytes() const {
+        return memoria.pico;
+    }
+    
+    /**
+     * @brief Muestra la memoria de la flota, la del registro y el contador global
+     */
+    void imprimirMemoria() const {
+        size_t total = bytesEstructura();
+        size_t mayor = 0;
+        const char* masPesado = "-";
+        
+        NodoGestion* actual = cabeza;
+        while (actual != NULL) {
+            size_t bytes = actual->sensor->obtenerBytesPropios();
+            total += bytes;
+            if (bytes > mayor) {
+                mayor = bytes;
+                masPesado = actual->sensor->obtenerNombre();
+            }
+            actual = actual->siguiente;
+        }
+        
+        printf("Memoria de la flota: %.1f KB (%.0f bytes por sensor, mayor: %s con %lu bytes)\n",
+               total / 1024.0, tamanio == 0 ? 0.0 : (double)total / tamanio,
+               masPesado, (unsigned long)mayor);
+        printf("Memoria del registro: %.1f KB reservados, pico %.1f KB\n",
+               memoria.vivos / 1024.0, memoria.pico / 1024.0);
+        ContadorMemoria::imprimirResumen();
+    }
+    
+    /**
+     * @brief Obtiene cuantos sensores esperan ser procesados
+     * 
+     * Se puede mirar desde otro hilo sin el candado del duenio; el valor
+     * puede ir un poco atrasado.
+     * 
+     * @return Numero de sensores sucios
+     */
+    int obtenerPendientes() const {
+        return __atomic_load_n(&sucios.cantidad, __ATOMIC_RELAXED);
+    }
 };
 
 #endif // LISTA_GESTION_H
\ No newline at end of file
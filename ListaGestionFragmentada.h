@@ -0,0 +1,329 @@
+#ifndef LISTA_GESTION_FRAGMENTADA_H
+#define LISTA_GESTION_FRAGMENTADA_H
+
+#include <cstdio>    // Para printf (C puro, sin STL)
+#include <cstdlib>   // Para malloc, free
+#include <pthread.h> // Hilos y candados POSIX (C puro)
+#include <sched.h>   // Para cpu_set_t
+#include <unistd.h>  // Para sysconf
+#include "ListaGestion.h"
+
+/**
+ * @brief Registro de sensores repartido en fragmentos por hash del ID
+ * 
+ * Cada fragmento es una ListaGestion completa (lista, indice y cola de
+ * sucios) con su propio candado, asi que hilos que trabajan con sensores
+ * de fragmentos distintos no se estorban. Un ID siempre cae en el mismo
+ * fragmento: buscar, registrar e ingerir solo tocan ese fragmento.
+ * 
+ * procesarTodos reparte los fragmentos en rangos seguidos entre tantos
+ * trabajadores como nucleos (sin pasar del numero de fragmentos). El
+ * primer rango lo hace el hilo que llama; los demas tienen un hilo que
+ * se crea una sola vez en el constructor (fijado a un nucleo si se
+ * pidio), se despierta con una variable de condicion y se une en el
+ * destructor. Con un solo nucleo no hay hilos extra. Los fragmentos sin
+ * sensores pendientes se saltan sin tomar su candado.
+ */
+class ListaGestionFragmentada {
+private:
+    /**
+     * @brief Un fragmento; el relleno evita compartir linea de cache con el siguiente
+     */
+    struct Fragmento {
+        ListaGestion lista;      // Sensores de este fragmento
+        pthread_mutex_t candado; // Protege la lista y los sensores del fragmento
+        char relleno[64];
+        
+        /**
+         * @brief Constructor que prepara el candado
+         */
+        Fragmento() {
+            pthread_mutex_init(&candado, NULL);
+        }
+        
+        /**
+         * @brief Destructor que libera el candado (la lista libera sus sensores)
+         */
+        ~Fragmento() {
+            pthread_mutex_destroy(&candado);
+        }
+    };
+    
+    /**
+     * @brief Trabajador de un rango de fragmentos
+     */
+    struct Trabajador {
+        ListaGestionFragmentada* registro;
+        int desde;       // Primer fragmento que procesa
+        int hasta;       // Uno despues del ultimo
+        int nucleo;      // Nucleo al que me fijo, -1 para no fijar
+        int procesados;  // Resultado de la ultima pasada
+        bool activo;     // Tiene hilo propio (el primero, o si no se pudo crear, no)
+        pthread_t hilo;
+    };
+    
+    Fragmento* fragmentos;       // Arreglo de fragmentos
+    int cantidad;                // Cuantos fragmentos hay
+    bool fijarNucleos;           // Si cada trabajador se fija a un nucleo
+    Trabajador* trabajadores;    // Uno por nucleo, sin pasar de cantidad
+    int numTrabajadores;         // Cuantos hay
+    pthread_mutex_t control;     // Protege pasada, pendientes y terminar
+    pthread_cond_t hayPasada;    // Despierta a los trabajadores
+    pthread_cond_t pasadaLista;  // Avisa que el ultimo trabajador termino
+    pthread_mutex_t enCurso;     // Una sola pasada a la vez
+    unsigned pasada;             // Numero de la pasada pedida
+    int pendientes;              // Trabajadores que no han terminado la pasada
+    bool terminar;               // El destructor pide que salgan
+    
+    // No se copia: es duenio de los fragmentos y de los hilos
+    ListaGestionFragmentada(const ListaGestionFragmentada&);
+    ListaGestionFragmentada& operator=(const ListaGestionFragmentada&);
+    
+    /**
+     * @brief Procesa un fragmento con su candado
+     * @param f Fragmento
+     * @return Sensores procesados
+     */
+    static int procesarFragmento(Fragmento& f) {
+        pthread_mutex_lock(&f.candado);
+        int procesados = f.lista.procesarTodos();
+        pthread_mutex_unlock(&f.candado);
+        return procesados;
+    }
+    
+    /**
+     * @brief Procesa los fragmentos de un trabajador que tienen pendientes
+     * @param t Trabajador
+     */
+    static void procesarRango(Trabajador* t) {
+        ListaGestionFragmentada* r = t->registro;
+        int procesados = 0;
+        for (int i = t->desde; i < t->hasta; i++) {
+            if (r->fragmentos[i].lista.obtenerPendientes() > 0) procesados += procesarFragmento(r->fragmentos[i]);
+        }
+        t->procesados = procesados;
+    }
+    
+    /**
+     * @brief Ciclo de un trabajador: espera una pasada, procesa su rango y avisa
+     * @param arg Apuntador al Trabajador
+     * @return Siempre NULL
+     */
+    static void* trabajar(void* arg) {
+        Trabajador* t = (Trabajador*)arg;
+        ListaGestionFragmentada* r = t->registro;
+        if (t->nucleo >= 0) {
+            cpu_set_t nucleos;
+            CPU_ZERO(&nucleos);
+            CPU_SET(t->nucleo, &nucleos);
+            pthread_setaffinity_np(pthread_self(), sizeof(nucleos), &nucleos);
+        }
+        
+        // Parto de la pasada 0 del constructor: si el hilo arranca tarde
+        // y ya se pidio una pasada, la veo como nueva y no se pierde
+        unsigned vista = 0;
+        pthread_mutex_lock(&r->control);
+        while (true) {
+            while (r->pasada == vista && !r->terminar) pthread_cond_wait(&r->hayPasada, &r->control);
+            if (r->terminar) break;
+            vista = r->pasada;
+            pthread_mutex_unlock(&r->control);
+            
+            procesarRango(t);
+            
+            pthread_mutex_lock(&r->control);
+            if (--r->pendientes == 0) pthread_cond_signal(&r->pasadaLista);
+        }
+        pthread_mutex_unlock(&r->control);
+        return NULL;
+    }
+
+public:
+    /**
+     * @brief Constructor que crea los fragmentos vacios y sus trabajadores
+     * 
+     * Si algun hilo no se puede crear, procesarTodos procesa ese rango
+     * en el hilo que llama.
+     * 
+     * @param fragmentosDeseados Cuantos fragmentos (al menos 1)
+     * @param fijar Si cada trabajador se fija a un nucleo
+     */
+    ListaGestionFragmentada(int fragmentosDeseados, bool fijar = true)
+        : cantidad(fragmentosDeseados < 1 ? 1 : fragmentosDeseados), fijarNucleos(fijar),
+          pasada(0), pendientes(0), terminar(false) {
+        fragmentos = new Fragmento[cantidad];
+        pthread_mutex_init(&control, NULL);
+        pthread_cond_init(&hayPasada, NULL);
+        pthread_cond_init(&pasadaLista, NULL);
+        pthread_mutex_init(&enCurso, NULL);
+        
+        long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+        if (nucleos < 1) nucleos = 1;
+        numTrabajadores = nucleos < cantidad ? (int)nucleos : cantidad;
+        trabajadores = (Trabajador*)malloc(sizeof(Trabajador) * numTrabajadores);
+        for (int i = 0; i < numTrabajadores; i++) {
+            Trabajador& t = trabajadores[i];
+            t.registro = this;
+            t.desde = (int)((long long)cantidad * i / numTrabajadores);
+            t.hasta = (int)((long long)cantidad * (i + 1) / numTrabajadores);
+            t.nucleo = fijarNucleos ? i : -1;
+            t.procesados = 0;
+            
+            // El primer rango lo hace el hilo que llama a procesarTodos
+            t.activo = i > 0 && pthread_create(&t.hilo, NULL, trabajar, &t) == 0;
+        }
+        BITACORA("[Sistema] Registro fragmentado con %d fragmentos y %d trabajadores.\n", cantidad,
+                 numTrabajadores);
+    }
+    
+    /**
+     * @brief Destructor que une a los trabajadores y libera los fragmentos y sus sensores
+     */
+    ~ListaGestionFragmentada() {
+        pthread_mutex_lock(&control);
+        terminar = true;
+        pthread_cond_broadcast(&hayPasada);
+        pthread_mutex_unlock(&control);
+        for (int i = 0; i < numTrabajadores; i++) {
+            if (trabajadores[i].activo) pthread_join(trabajadores[i].hilo, NULL);
+        }
+        free(trabajadores);
+        pthread_mutex_destroy(&enCurso);
+        pthread_cond_destroy(&pasadaLista);
+        pthread_cond_destroy(&hayPasada);
+        pthread_mutex_destroy(&control);
+        delete[] fragmentos;
+    }
+    
+    /**
+     * @brief Calcula el fragmento al que pertenece un ID
+     * 
+     * Uso los bits altos del hash (multiplicar y recorrer) porque los
+     * bajos son los que usa el indice dentro de cada fragmento.
+     * 
+     * @param id Identificador del sensor
+     * @return Indice del fragmento
+     */
+    int fragmentoDe(const char* id) const {
+        return (int)(((unsigned long long)hashIdSensor(id) * (unsigned)cantidad) >> 32);
+    }
+    
+    /**
+     * @brief Registra un sensor en su fragmento
+     * @param sensor Sensor a registrar (el registro se queda con el)
+     */
+    void agregarSensor(SensorBase* sensor) {
+        Fragmento& f = fragmentos[fragmentoDe(sensor->obtenerNombre())];
+        pthread_mutex_lock(&f.candado);
+        f.lista.agregarSensor(sensor);
+        pthread_mutex_unlock(&f.candado);
+    }
+    
+    /**
+     * @brief Busca un sensor solo en su fragmento
+     * 
+     * El apuntador sigue siendo valido despues de soltar el candado (los
+     * sensores no se borran mientras viva el registro), pero para
+     * escribirle lecturas desde varios hilos hay que usar ingerir().
+     * 
+     * @param id Identificador del sensor
+     * @return Puntero al sensor si lo encuentra, NULL si no
+     */
+    SensorBase* buscarSensor(const char* id) {
+        Fragmento& f = fragmentos[fragmentoDe(id)];
+        pthread_mutex_lock(&f.candado);
+        SensorBase* sensor = f.lista.buscarSensor(id);
+        pthread_mutex_unlock(&f.candado);
+        return sensor;
+    }
+    
+    /**
+     * @brief Agrega lecturas a un sensor con el candado de su fragmento
+     * @param id Identificador del sensor
+     * @param valores Lecturas en orden de llegada
+     * @param cantidadValores Cuantas lecturas
+     * @return true si el sensor existe
+     */
+    bool ingerir(const char* id, const double* valores, int cantidadValores) {
+        Fragmento& f = fragmentos[fragmentoDe(id)];
+        pthread_mutex_lock(&f.candado);
+        SensorBase* sensor = f.lista.buscarSensor(id);
+        if (sensor != NULL) sensor->registrarLote(valores, cantidadValores);
+        pthread_mutex_unlock(&f.candado);
+        return sensor != NULL;
+    }
+    
+    /**
+     * @brief Procesa los sensores con lecturas nuevas, cada rango en su trabajador
+     * @return Total de sensores procesados
+     */
+    int procesarTodos() {
+        pthread_mutex_lock(&enCurso);
+        int activos = 0;
+        for (int i = 0; i < numTrabajadores; i++) activos += trabajadores[i].activo;
+        
+        if (activos > 0) {
+            pthread_mutex_lock(&control);
+            pendientes = activos;
+            pasada++;
+            pthread_cond_broadcast(&hayPasada);
+            pthread_mutex_unlock(&control);
+        }
+        
+        // Los rangos sin hilo (el primero siempre) los hago aqui mismo
+        for (int i = 0; i < numTrabajadores; i++) {
+            if (!trabajadores[i].activo) procesarRango(&trabajadores[i]);
+        }
+        
+        if (activos > 0) {
+            pthread_mutex_lock(&control);
+            while (pendientes > 0) pthread_cond_wait(&pasadaLista, &control);
+            pthread_mutex_unlock(&control);
+        }
+        
+        int total = 0;
+        for (int i = 0; i < numTrabajadores; i++) total += trabajadores[i].procesados;
+        pthread_mutex_unlock(&enCurso);
+        return total;
+    }
+    
+    /**
+     * @brief Total de sensores en todos los fragmentos
+     * @return Numero de sensores
+     */
+    int obtenerTamanio() {
+        int total = 0;
+        for (int i = 0; i < cantidad; i++) {
+            pthread_mutex_lock(&fragmentos[i].candado);
+            total += fragmentos[i].lista.obtenerTamanio();
+            pthread_mutex_unlock(&fragmentos[i].candado);
+        }
+        return total;
+    }
+    
+    /**
+     * @brief Cantidad de fragmentos
+     * @return Numero de fragmentos
+     */
+    int obtenerFragmentos() const {
+        return cantidad;
+    }
+    
+    /**
+     * @brief Muestra cuantos sensores tiene cada fragmento
+     */
+    void imprimirReparto() {
+        int menor = -1;
+        int mayor = 0;
+        for (int i = 0; i < cantidad; i++) {
+            pthread_mutex_lock(&fragmentos[i].candado);
+            int n = fragmentos[i].lista.obtenerTamanio();
+            pthread_mutex_unlock(&fragmentos[i].candado);
+            if (menor < 0 || n < menor) menor = n;
+            if (n > mayor) mayor = n;
+        }
+        printf("Fragmentos: %d, sensores por fragmento entre %d y %d\n", cantidad, menor, mayor);
+    }
+};
+
+#endif // LISTA_GESTION_FRAGMENTADA_H
\ No newline at end of file
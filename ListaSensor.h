@@ -4,6 +4,11 @@
 
 #include <cstdio>   // Para printf (C puro, no STL)
 #include <cstdlib>  // Para NULL
+#include "Bitacora.h"
+#include "Metricas.h"
+#include "ContadorMemoria.h"
+#include "RasgosLectura.h"
+#include "ArenaBloques.h"
 
 /**
  * @brief Estructura que representa un nodo de la lista
@@ -19,23 +24,72 @@ struct Nodo {
      * @param valor El dato que quiero guardar en este nodo
      */
     Nodo(T valor) : dato(valor), siguiente(NULL) {}
+    
+    /**
+     * @brief Pido la memoria del nodo a traves del contador global
+     * @param bytes Tamanio que pide el compilador
+     * @return Memoria para el nodo
+     */
+    static void* operator new(size_t bytes) {
+        return ContadorMemoria::pedir(bytes);
+    }
+    
+    /**
+     * @brief Devuelvo la memoria del nodo al contador global
+     * @param p Memoria del nodo
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void operator delete(void* p, size_t bytes) {
+        ContadorMemoria::devolver(p, bytes);
+    }
 };
 
+/**
+ * @brief Posicion dentro de un historial para leerlo por partes
+ * 
+ * Sirve para copiar las lecturas de un sensor en bloques grandes (por
+ * ejemplo al exportar) sin recorrer la lista desde el inicio cada vez.
+ */
+struct CursorLecturas {
+    const void* posicion;  // Nodo donde me quede (depende de la lista)
+    int indice;            // Dato dentro del nodo (solo en listas por bloques)
+    bool iniciado;         // false hasta la primera copia
+    
+    /**
+     * @brief Constructor que apunta al inicio del historial
+     */
+    CursorLecturas() : posicion(NULL), indice(0), iniciado(false) {}
+};
+
+/**
+ * @brief Lista de lecturas; los rasgos del tipo eligen la implementacion
+ * 
+ * Con EnBloques = false es la lista enlazada de un nodo por dato (sirve
+ * para cualquier T y queda como referencia). Con EnBloques = true se usa
+ * la especializacion de ListaSensorBloques.h.
+ * 
+ * @tparam T Tipo de dato que guardaran los nodos
+ * @tparam EnBloques Si se guardan los datos en bloques contiguos
+ */
+template <typename T, bool EnBloques = RasgosLectura<T>::EN_BLOQUES>
+class ListaSensor;
+
 /**
  * @brief Clase que maneja una lista enlazada simple generica
  * @tparam T Tipo de dato que guardaran los nodos
  */
-template <typename T>
+template <typename T, bool EnBloques>
 class ListaSensor {
 private:
     Nodo<T>* cabeza;  // Apuntador al primer nodo de mi lista
+    Nodo<T>* cola;    // Apuntador al ultimo nodo (para insertar sin recorrer)
     int tamanio;      // Contador de cuantos nodos tengo
     
 public:
     /**
      * @brief Constructor que crea una lista vacia
      */
-    ListaSensor() : cabeza(NULL), tamanio(0) {
+    ListaSensor() : cabeza(NULL), cola(NULL), tamanio(0) {
         // Inicio la lista sin nodos
     }
     
@@ -47,8 +101,7 @@ public:
         Nodo<T>* actual = cabeza;  // Empiezo desde el primer nodo
         while (actual != NULL) {
             Nodo<T>* siguiente = actual->siguiente;  // Guardo la referencia al siguiente
-            printf("[Log] Liberando Nodo\n");  // Mensaje sin STL
-            delete actual;  // Borro el nodo actual
+            delete actual;  // Borro el nodo actual (sin mensaje: son millones)
             actual = siguiente;  // Avanzo al siguiente nodo
         }
     }
@@ -57,7 +110,7 @@ public:
      * @brief Constructor de copia para hacer copias profundas
      * @param otra La lista que quiero copiar
      */
-    ListaSensor(const ListaSensor& otra) : cabeza(NULL), tamanio(0) {
+    ListaSensor(const ListaSensor& otra) : cabeza(NULL), cola(NULL), tamanio(0) {
         // Copio cada nodo de la otra lista para tener mi propia copia
         Nodo<T>* actual = otra.cabeza;
         while (actual != NULL) {
@@ -77,6 +130,7 @@ public:
             // Primero borro mi contenido actual
             this->~ListaSensor();
             cabeza = NULL;
+            cola = NULL;
             tamanio = 0;
             
             // Ahora copio los nodos de la otra lista
@@ -94,6 +148,8 @@ public:
      * @param valor El dato que quiero agregar
      */
     void insertarAlFinal(T valor) {
+        MEDIR_OPERACION(OP_INSERTAR);
+        
         // Creo un nuevo nodo con el valor
         Nodo<T>* nuevoNodo = new Nodo<T>(valor);
         
@@ -101,16 +157,46 @@ public:
         if (cabeza == NULL) {
             cabeza = nuevoNodo;
         } else {
-            // Si no, busco el ultimo nodo y lo engancho ahi
-            Nodo<T>* actual = cabeza;
-            while (actual->siguiente != NULL) {
-                actual = actual->siguiente;  // Avanzo hasta el final
-            }
-            actual->siguiente = nuevoNodo;  // Engancho el nuevo nodo al final
+            // Si no, lo engancho despues del ultimo nodo (ya se cual es)
+            cola->siguiente = nuevoNodo;
         }
+        cola = nuevoNodo;
         
         tamanio++;  // Incremento el contador
-        printf("[Log] Insertando Nodo\n");  // Mensaje sin STL
+        BITACORA("[Log] Insertando Nodo\n");  // Mensaje sin STL
+    }
+    
+    /**
+     * @brief Inserta varios datos al final de la lista de una sola vez
+     * 
+     * Armo la cadena de nodos por separado y la engancho al final con un
+     * solo movimiento, en lugar de repetir insertarAlFinal por cada dato.
+     * 
+     * @param valores Arreglo con los datos en orden de llegada
+     * @param cantidad Cuantos datos trae el arreglo
+     */
+    void insertarLote(const T* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        MEDIR_OPERACION(OP_INSERTAR_LOTE);
+        
+        // Construyo la cadena nueva
+        Nodo<T>* primero = new Nodo<T>(valores[0]);
+        Nodo<T>* ultimo = primero;
+        for (int i = 1; i < cantidad; i++) {
+            ultimo->siguiente = new Nodo<T>(valores[i]);
+            ultimo = ultimo->siguiente;
+        }
+        
+        // La engancho al final
+        if (cabeza == NULL) {
+            cabeza = primero;
+        } else {
+            cola->siguiente = primero;
+        }
+        cola = ultimo;
+        
+        tamanio += cantidad;
+        BITACORA("[Log] Insertando lote de %d Nodos\n", cantidad);  // Mensaje sin STL
     }
     
     /**
@@ -135,6 +221,8 @@ public:
      * @return El promedio como double
      */
     double calcularPromedio() const {
+        MEDIR_OPERACION(OP_CALCULAR_PROMEDIO);
+        
         // Si no hay nodos regreso cero
         if (tamanio == 0) return 0.0;
         
@@ -154,6 +242,8 @@ public:
      * @return El valor eliminado
      */
     T eliminarMasBajo() {
+        MEDIR_OPERACION(OP_ELIMINAR_MAS_BAJO);
+        
         // Si no hay nodos, regreso cero
         if (cabeza == NULL) return T(0);
         
@@ -184,12 +274,28 @@ public:
             prevMin->siguiente = minNodo->siguiente;
         }
         
+        // Si borre el ultimo, la cola ahora es el nodo anterior
+        if (minNodo == cola) {
+            cola = prevMin;
+        }
+        
         delete minNodo;  // Borro el nodo
         tamanio--;       // Decremento el contador
         
         return valorMin;  // Regreso el valor eliminado
     }
     
+    /**
+     * @brief Elimina el valor mas bajo avisando si la lista estaba vacia
+     * @param salida Donde dejo el valor eliminado (no se toca si esta vacia)
+     * @return true si habia un valor que eliminar
+     */
+    bool extraerMinimo(T& salida) {
+        if (cabeza == NULL) return false;
+        salida = eliminarMasBajo();
+        return true;
+    }
+    
     /**
      * @brief Obtiene la cantidad de nodos en la lista
      * @return Numero de elementos
@@ -198,6 +304,42 @@ public:
         return tamanio;  // Regreso cuantos nodos tengo
     }
     
+    /**
+     * @brief Copia datos a partir de un cursor, convirtiendolos a otro tipo
+     * 
+     * Cada llamada continua donde se quedo la anterior, asi que leer toda
+     * la lista por partes sigue siendo O(n).
+     * 
+     * @tparam D Tipo destino (ej: double)
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible en destino
+     * @param cursor Posicion de lectura (se actualiza)
+     * @return Cuantos datos copie
+     */
+    template <typename D>
+    int copiarComo(D* destino, int maximo, CursorLecturas& cursor) const {
+        if (!cursor.iniciado) {
+            cursor.posicion = cabeza;
+            cursor.iniciado = true;
+        }
+        const Nodo<T>* actual = (const Nodo<T>*)cursor.posicion;
+        int copiados = 0;
+        while (actual != NULL && copiados < maximo) {
+            destino[copiados++] = (D)actual->dato;
+            actual = actual->siguiente;
+        }
+        cursor.posicion = actual;
+        return copiados;
+    }
+    
+    /**
+     * @brief Bytes que ocupan los nodos de la lista
+     * @return Memoria de los nodos (sin contar el objeto lista)
+     */
+    size_t bytesUsados() const {
+        return (size_t)tamanio * sizeof(Nodo<T>);
+    }
+    
     /**
      * @brief Verifica si la lista esta vacia
      * @return true si no tiene nodos
@@ -207,4 +349,7 @@ public:
     }
 };
 
+// Especializacion para tipos que se pueden copiar con memcpy
+#include "ListaSensorBloques.h"
+
 #endif // LISTA_SENSOR_H
\ No newline at end of file
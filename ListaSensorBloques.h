@@ -0,0 +1,407 @@
+#ifndef LISTA_SENSOR_BLOQUES_H
+#define LISTA_SENSOR_BLOQUES_H
+
+#include <cstring>  // Para memcpy, memmove (C puro, sin STL)
+#include <new>      // Para construir bloques dentro de una arena
+
+// Este archivo se incluye desde ListaSensor.h, no directamente
+
+/**
+ * @brief Bloque de la lista: varios datos contiguos y el enlace al siguiente
+ * @tparam T Tipo de dato (se copia con memcpy)
+ */
+template <typename T>
+struct BloqueLecturas {
+    BloqueLecturas<T>* siguiente;                  // Siguiente bloque de la lista
+    int usados;                                    // Cuantos datos validos tengo
+    T datos[RasgosLectura<T>::DATOS_POR_BLOQUE];   // Datos en orden de llegada
+    
+    /**
+     * @brief Constructor que deja el bloque vacio
+     */
+    BloqueLecturas() : siguiente(NULL), usados(0) {}
+    
+    /**
+     * @brief Pido la memoria del bloque a traves del contador global
+     * @param bytes Tamanio que pide el compilador
+     * @return Memoria para el bloque
+     */
+    static void* operator new(size_t bytes) {
+        return ContadorMemoria::pedir(bytes);
+    }
+    
+    /**
+     * @brief Devuelvo la memoria del bloque al contador global
+     * @param p Memoria del bloque
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void operator delete(void* p, size_t bytes) {
+        ContadorMemoria::devolver(p, bytes);
+    }
+};
+
+/**
+ * @brief Lista por bloques para tipos que se copian con memcpy
+ * 
+ * Misma interfaz que la lista generica, pero cada nodo guarda
+ * DATOS_POR_BLOQUE lecturas seguidas: una asignacion por bloque en lugar
+ * de una por dato, lotes copiados con memcpy y recorridos que el
+ * compilador puede vectorizar. Las sumas usan el acumulador que indiquen
+ * los rasgos (long long para enteros).
+ * 
+ * Ningun bloque queda vacio: si eliminarMasBajo vacia uno, se libera.
+ * Los bloques salen del contador de memoria, o de una ArenaBloques si
+ * se le asigna una; si esa arena se esta cerrando, el destructor no
+ * recorre los bloques (la arena los suelta todos juntos).
+ * 
+ * @tparam T Tipo de dato
+ */
+template <typename T>
+class ListaSensor<T, true> {
+private:
+    typedef BloqueLecturas<T> Bloque;
+    typedef typename RasgosLectura<T>::Acumulador Acumulador;
+    static constexpr int CAPACIDAD = RasgosLectura<T>::DATOS_POR_BLOQUE;
+    
+    Bloque* cabeza;  // Primer bloque
+    Bloque* cola;    // Ultimo bloque (ahi se inserta)
+    int tamanio;     // Total de datos en todos los bloques
+    int bloques;     // Cantidad de bloques
+    ArenaBloques* arena;  // De donde salen los bloques, NULL para pedirlos sueltos
+    
+    /**
+     * @brief Devuelve un bloque a donde se pidio
+     * @param bloque Bloque ya desenganchado
+     * @param origen Arena de la que salio, NULL si se pidio suelto
+     */
+    static void soltarBloque(Bloque* bloque, ArenaBloques* origen) {
+        if (origen == NULL) {
+            delete bloque;
+        } else {
+            bloque->~Bloque();
+            origen->devolver(bloque);
+        }
+    }
+    
+    /**
+     * @brief Engancha un bloque vacio al final
+     * @return El bloque nuevo
+     */
+    Bloque* agregarBloque() {
+        Bloque* nuevo = arena == NULL ? new Bloque() : ::new (arena->tomar()) Bloque();
+        if (cabeza == NULL) {
+            cabeza = nuevo;
+        } else {
+            cola->siguiente = nuevo;
+        }
+        cola = nuevo;
+        bloques++;
+        return nuevo;
+    }
+    
+    /**
+     * @brief Copia datos al final llenando primero el ultimo bloque
+     * @param valores Datos en orden
+     * @param cantidad Cuantos son
+     */
+    void agregarDatos(const T* valores, int cantidad) {
+        while (cantidad > 0) {
+            Bloque* destino = cola;
+            if (destino == NULL || destino->usados == CAPACIDAD) destino = agregarBloque();
+            int espacio = CAPACIDAD - destino->usados;
+            int n = cantidad < espacio ? cantidad : espacio;
+            memcpy(destino->datos + destino->usados, valores, (size_t)n * sizeof(T));
+            destino->usados += n;
+            tamanio += n;
+            valores += n;
+            cantidad -= n;
+        }
+    }
+    
+    /**
+     * @brief Libera todos los bloques y deja la lista vacia
+     */
+    void liberarBloques() {
+        Bloque* actual = cabeza;
+        while (actual != NULL) {
+            Bloque* siguiente = actual->siguiente;
+            soltarBloque(actual, arena);
+            actual = siguiente;
+        }
+        cabeza = NULL;
+        cola = NULL;
+        tamanio = 0;
+        bloques = 0;
+    }
+    
+    /**
+     * @brief Copia un tramo convirtiendo cada dato
+     * @param destino Donde copio
+     * @param origen Datos del bloque
+     * @param n Cuantos datos
+     */
+    template <typename D>
+    static void copiarTramo(D* destino, const T* origen, int n) {
+        for (int i = 0; i < n; i++) destino[i] = (D)origen[i];
+    }
+    
+    /**
+     * @brief Copia un tramo del mismo tipo de un solo golpe
+     * @param destino Donde copio
+     * @param origen Datos del bloque
+     * @param n Cuantos datos
+     */
+    static void copiarTramo(T* destino, const T* origen, int n) {
+        memcpy(destino, origen, (size_t)n * sizeof(T));
+    }
+
+public:
+    /**
+     * @brief Constructor que crea una lista vacia
+     */
+    ListaSensor() : cabeza(NULL), cola(NULL), tamanio(0), bloques(0), arena(NULL) {}
+    
+    /**
+     * @brief Destructor que libera todos los bloques
+     */
+    ~ListaSensor() {
+        if (arena != NULL && arena->enCierre()) return;  // La arena los suelta enteros
+        liberarBloques();
+    }
+    
+    /**
+     * @brief Constructor de copia (copia profunda, bloque por bloque)
+     * 
+     * La copia pide sus bloques sueltos, no en la arena de la otra.
+     * 
+     * @param otra La lista que quiero copiar
+     */
+    ListaSensor(const ListaSensor& otra) : cabeza(NULL), cola(NULL), tamanio(0), bloques(0), arena(NULL) {
+        for (const Bloque* b = otra.cabeza; b != NULL; b = b->siguiente) {
+            agregarDatos(b->datos, b->usados);
+        }
+    }
+    
+    /**
+     * @brief Operador de asignacion para copiar una lista en otra
+     * @param otra La lista fuente
+     * @return Referencia a esta lista
+     */
+    ListaSensor& operator=(const ListaSensor& otra) {
+        if (this != &otra) {
+            liberarBloques();
+            for (const Bloque* b = otra.cabeza; b != NULL; b = b->siguiente) {
+                agregarDatos(b->datos, b->usados);
+            }
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Cambia de donde salen los bloques
+     * 
+     * Los datos que ya tenia se copian a bloques nuevos de la arena (o
+     * sueltos si es NULL). Si las casillas de la arena no alcanzan para
+     * un bloque, sigo pidiendolos sueltos.
+     * 
+     * @param nueva Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArena(ArenaBloques* nueva) {
+        if (nueva != NULL && sizeof(Bloque) > nueva->tamanioCasilla()) nueva = NULL;
+        if (nueva == arena) return;
+        
+        Bloque* viejos = cabeza;
+        ArenaBloques* anterior = arena;
+        cabeza = NULL;
+        cola = NULL;
+        tamanio = 0;
+        bloques = 0;
+        arena = nueva;
+        while (viejos != NULL) {
+            Bloque* siguiente = viejos->siguiente;
+            agregarDatos(viejos->datos, viejos->usados);
+            soltarBloque(viejos, anterior);
+            viejos = siguiente;
+        }
+    }
+    
+    /**
+     * @brief Inserta un nuevo dato al final de la lista
+     * @param valor El dato que quiero agregar
+     */
+    void insertarAlFinal(T valor) {
+        MEDIR_OPERACION(OP_INSERTAR);
+        
+        // Solo pido memoria cuando el ultimo bloque se lleno
+        Bloque* destino = cola;
+        if (destino == NULL || destino->usados == CAPACIDAD) destino = agregarBloque();
+        destino->datos[destino->usados++] = valor;
+        
+        tamanio++;
+        BITACORA("[Log] Insertando lectura (bloque con %d)\n", destino->usados);
+    }
+    
+    /**
+     * @brief Inserta varios datos al final con memcpy por bloque
+     * @param valores Arreglo con los datos en orden de llegada
+     * @param cantidad Cuantos datos trae el arreglo
+     */
+    void insertarLote(const T* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        MEDIR_OPERACION(OP_INSERTAR_LOTE);
+        agregarDatos(valores, cantidad);
+        BITACORA("[Log] Insertando lote de %d lecturas\n", cantidad);
+    }
+    
+    /**
+     * @brief Busca un valor en la lista
+     * @param valor El dato que estoy buscando
+     * @return true si lo encuentra, false si no
+     */
+    bool buscar(T valor) const {
+        for (const Bloque* b = cabeza; b != NULL; b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                if (b->datos[i] == valor) return true;
+            }
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Calcula el promedio de todos los valores
+     * @return El promedio como double
+     */
+    double calcularPromedio() const {
+        MEDIR_OPERACION(OP_CALCULAR_PROMEDIO);
+        if (tamanio == 0) return 0.0;
+        
+        // Sumo en el orden de llegada, igual que la lista generica
+        Acumulador suma = 0;
+        for (const Bloque* b = cabeza; b != NULL; b = b->siguiente) {
+            const T* datos = b->datos;
+            int n = b->usados;
+            for (int i = 0; i < n; i++) suma += datos[i];
+        }
+        return (double)suma / tamanio;
+    }
+    
+    /**
+     * @brief Encuentra y elimina el valor mas bajo (el primero si se repite)
+     * @return El valor eliminado, T(0) si la lista esta vacia
+     */
+    T eliminarMasBajo() {
+        MEDIR_OPERACION(OP_ELIMINAR_MAS_BAJO);
+        if (cabeza == NULL) return T(0);
+        
+        // Busco el minimo recordando su bloque y el bloque anterior
+        Bloque* bloqueMin = cabeza;
+        Bloque* previoMin = NULL;
+        int indiceMin = 0;
+        T minimo = cabeza->datos[0];
+        Bloque* previo = NULL;
+        for (Bloque* b = cabeza; b != NULL; previo = b, b = b->siguiente) {
+            for (int i = 0; i < b->usados; i++) {
+                if (b->datos[i] < minimo) {
+                    minimo = b->datos[i];
+                    bloqueMin = b;
+                    previoMin = previo;
+                    indiceMin = i;
+                }
+            }
+        }
+        
+        // Recorro el resto del bloque un lugar hacia atras
+        int restantes = bloqueMin->usados - indiceMin - 1;
+        memmove(bloqueMin->datos + indiceMin, bloqueMin->datos + indiceMin + 1,
+                (size_t)restantes * sizeof(T));
+        bloqueMin->usados--;
+        tamanio--;
+        
+        // Si el bloque quedo vacio lo desconecto y lo libero
+        if (bloqueMin->usados == 0) {
+            if (previoMin == NULL) {
+                cabeza = bloqueMin->siguiente;
+            } else {
+                previoMin->siguiente = bloqueMin->siguiente;
+            }
+            if (bloqueMin == cola) cola = previoMin;
+            soltarBloque(bloqueMin, arena);
+            bloques--;
+        }
+        return minimo;
+    }
+    
+    /**
+     * @brief Elimina el valor mas bajo avisando si la lista estaba vacia
+     * @param salida Donde dejo el valor eliminado (no se toca si esta vacia)
+     * @return true si habia un valor que eliminar
+     */
+    bool extraerMinimo(T& salida) {
+        if (cabeza == NULL) return false;
+        salida = eliminarMasBajo();
+        return true;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de datos en la lista
+     * @return Numero de elementos
+     */
+    int obtenerTamanio() const {
+        return tamanio;
+    }
+    
+    /**
+     * @brief Copia datos a partir de un cursor, convirtiendolos a otro tipo
+     * 
+     * Copia tramos enteros de cada bloque; si D es el mismo T usa memcpy.
+     * 
+     * @tparam D Tipo destino (ej: double)
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible en destino
+     * @param cursor Posicion de lectura (se actualiza)
+     * @return Cuantos datos copie
+     */
+    template <typename D>
+    int copiarComo(D* destino, int maximo, CursorLecturas& cursor) const {
+        if (!cursor.iniciado) {
+            cursor.posicion = cabeza;
+            cursor.indice = 0;
+            cursor.iniciado = true;
+        }
+        const Bloque* actual = (const Bloque*)cursor.posicion;
+        int indice = cursor.indice;
+        int copiados = 0;
+        while (actual != NULL && copiados < maximo) {
+            int n = actual->usados - indice;
+            if (n > maximo - copiados) n = maximo - copiados;
+            copiarTramo(destino + copiados, actual->datos + indice, n);
+            copiados += n;
+            indice += n;
+            if (indice == actual->usados) {
+                actual = actual->siguiente;
+                indice = 0;
+            }
+        }
+        cursor.posicion = actual;
+        cursor.indice = indice;
+        return copiados;
+    }
+    
+    /**
+     * @brief Bytes que ocupan los bloques de la lista
+     * @return Memoria de los bloques (sin contar el objeto lista)
+     */
+    size_t bytesUsados() const {
+        return (size_t)bloques * sizeof(Bloque);
+    }
+    
+    /**
+     * @brief Verifica si la lista esta vacia
+     * @return true si no tiene datos
+     */
+    bool estaVacia() const {
+        return cabeza == NULL;
+    }
+};
+
+#endif // LISTA_SENSOR_BLOQUES_H
\ No newline at end of file
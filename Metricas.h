@@ -0,0 +1,415 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+/**
+ * @file Metricas.h
+ * @brief Contadores y latencias por operacion del camino caliente
+ * 
+ * Cada hilo cuenta en variables thread_local comunes (un incremento por
+ * llamada) y solo cada MUESTREO_METRICAS llamadas de una operacion
+ * publica la cuenta en su bloque compartido y toma el tiempo. El bloque
+ * usa atomicos relajados para que el reporte lo lea mientras se escribe.
+ * Cuando un hilo termina, sus cuentas pasan a un total de retirados y su
+ * bloque se recicla para el siguiente hilo.
+ * Compilando con -DSENSORES_METRICAS=0 las macros quedan vacias y no
+ * cuestan nada.
+ */
+
+#ifndef SENSORES_METRICAS
+#define SENSORES_METRICAS 1
+#endif
+
+/**
+ * @brief Operaciones que se miden
+ */
+enum OperacionMedida {
+    OP_INSERTAR = 0,        // ListaSensor::insertarAlFinal
+    OP_INSERTAR_LOTE,       // ListaSensor::insertarLote
+    OP_BUSCAR_SENSOR,       // ListaGestion::buscarSensor
+    OP_ELIMINAR_MAS_BAJO,   // ListaSensor::eliminarMasBajo
+    OP_CALCULAR_PROMEDIO,   // ListaSensor::calcularPromedio
+    OP_PROCESAR_TODOS,      // ListaGestion::procesarTodos
+    OP_CANTIDAD             // Cuantas operaciones hay (no es una operacion)
+};
+
+#if SENSORES_METRICAS
+
+#include <cstdio>    // Para printf (C puro, sin STL)
+#include <cstring>   // Para memset
+#include <pthread.h> // Para el candado del registro de hilos
+#include <unistd.h>  // Para usleep
+#include "HistogramaLatencia.h"
+#include "Reloj.h"
+#include "ContadorMemoria.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // Para __rdtsc
+#endif
+
+/**
+ * @brief Cada cuantas operaciones tomo el tiempo (potencia de dos)
+ * 
+ * Leer el reloj dos veces cuesta mas que una insercion (en una maquina
+ * virtual el TSC puede costar 25 ns por lectura); con 1 de cada 16 el
+ * sobrecosto pasaba del 10%. Una insercion por segundo por sensor en
+ * una flota de miles junta miles de muestras por minuto, suficiente para
+ * el histograma. Con la misma frecuencia se publica la cuenta local en
+ * el bloque del hilo, asi que el reporte puede quedarse corto hasta por
+ * MUESTREO_METRICAS - 1 llamadas por operacion en cada hilo que sigue
+ * vivo (el hilo que pide el reporte y los que terminaron son exactos).
+ */
+static const unsigned MUESTREO_METRICAS = 4096;
+
+/**
+ * @brief Lee el contador de tiempo mas barato disponible
+ * @return Ciclos del TSC en x86, nanosegundos en otras arquitecturas
+ */
+inline unsigned long long marcaMetricas() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (unsigned long long)relojNs();
+#endif
+}
+
+/**
+ * @brief Contadores de un solo hilo
+ */
+struct MetricasHilo {
+    long long conteo[OP_CANTIDAD];            // Veces que se llamo cada operacion
+    HistogramaLatencia latencia[OP_CANTIDAD]; // Duraciones muestreadas (en marcas)
+    MetricasHilo* siguiente;                  // Siguiente hilo registrado
+    
+    /**
+     * @brief Constructor que deja todo en cero
+     */
+    MetricasHilo() : siguiente(NULL) {
+        memset(conteo, 0, sizeof(conteo));
+    }
+    
+    /**
+     * @brief Suma llamadas ya contadas (solo desde el hilo duenio del bloque)
+     * 
+     * Hay un solo escritor, asi que leer y guardar con atomicos relajados
+     * basta para que el reporte lea sin carrera.
+     * 
+     * @param op Operacion
+     * @param llamadas Cuantas se suman
+     */
+    void publicar(int op, long long llamadas) {
+        long long n = __atomic_load_n(&conteo[op], __ATOMIC_RELAXED);
+        __atomic_store_n(&conteo[op], n + llamadas, __ATOMIC_RELAXED);
+    }
+    
+    /**
+     * @brief Suma este bloque a otro (puede correr mientras el duenio escribe)
+     * @param destino Bloque donde acumulo
+     */
+    void sumarA(MetricasHilo& destino) const {
+        for (int op = 0; op < OP_CANTIDAD; op++) {
+            destino.conteo[op] += __atomic_load_n(&conteo[op], __ATOMIC_RELAXED);
+            destino.latencia[op].combinar(latencia[op]);
+        }
+    }
+    
+    /**
+     * @brief Deja el bloque en cero para reciclarlo
+     */
+    void reiniciar() {
+        memset(conteo, 0, sizeof(conteo));
+        for (int op = 0; op < OP_CANTIDAD; op++) latencia[op].reiniciar();
+    }
+};
+
+/**
+ * @brief Lo que cada hilo cuenta sin publicar (thread_local, sin atomicos)
+ */
+struct MetricasLocales {
+    int faltan[OP_CANTIDAD];       // Llamadas sin publicar que aun caben; al bajar de 0 se publica
+    bool empezada[OP_CANTIDAD];    // Ya se publico esta operacion al menos una vez
+    MetricasHilo* bloque;          // Bloque compartido, NULL hasta la primera publicacion
+    
+    /**
+     * @brief Llamadas contadas que no se han publicado
+     * @param op Operacion
+     * @return Entre 0 y MUESTREO_METRICAS - 1
+     */
+    long long pendientes(int op) const {
+        return empezada[op] ? (long long)MUESTREO_METRICAS - 1 - faltan[op] : 0;
+    }
+};
+
+/**
+ * @brief Registro global de bloques por hilo
+ */
+class Metricas {
+private:
+    /**
+     * @brief Cabeza de la lista de bloques de los hilos vivos que han medido algo
+     */
+    static MetricasHilo*& cabeza() {
+        static MetricasHilo* primero = NULL;
+        return primero;
+    }
+    
+    /**
+     * @brief Bloques de hilos que ya terminaron, listos para reciclar
+     */
+    static MetricasHilo*& libres() {
+        static MetricasHilo* primero = NULL;
+        return primero;
+    }
+    
+    /**
+     * @brief Suma de lo que midieron los hilos que ya terminaron
+     */
+    static MetricasHilo& retirados() {
+        static MetricasHilo* total = new MetricasHilo();  // Nunca se libera: vive lo que el proceso
+        return *total;
+    }
+    
+    /**
+     * @brief Candado que protege las listas, los retirados y el reporte
+     */
+    static pthread_mutex_t* candado() {
+        static pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+        return &m;
+    }
+    
+    /**
+     * @brief Clave por hilo cuyo destructor retira el bloque al terminar el hilo
+     */
+    static pthread_key_t clave() {
+        struct Clave {
+            pthread_key_t valor;
+            Clave() {
+                pthread_key_create(&valor, retirarHilo);
+            }
+        };
+        static Clave c;
+        return c.valor;
+    }
+    
+    /**
+     * @brief Pasa las cuentas de un hilo que termina a los retirados y recicla su bloque
+     * @param arg Bloque del hilo (lo llama pthread al salir el hilo)
+     */
+    static void retirarHilo(void* arg) {
+        MetricasHilo* bloque = (MetricasHilo*)arg;
+        // Corre en el hilo que termina: todavia puedo leer lo que no publico
+        MetricasLocales& propias = locales();
+        pthread_mutex_lock(candado());
+        for (int op = 0; op < OP_CANTIDAD; op++) retirados().conteo[op] += propias.pendientes(op);
+        memset(propias.faltan, 0, sizeof(propias.faltan));
+        memset(propias.empezada, 0, sizeof(propias.empezada));
+        propias.bloque = NULL;
+        MetricasHilo** enlace = &cabeza();
+        while (*enlace != NULL && *enlace != bloque) enlace = &(*enlace)->siguiente;
+        if (*enlace == bloque) *enlace = bloque->siguiente;
+        bloque->sumarA(retirados());
+        bloque->reiniciar();
+        bloque->siguiente = libres();
+        libres() = bloque;
+        pthread_mutex_unlock(candado());
+    }
+    
+    /**
+     * @brief Toma un bloque (reciclado si hay) y lo registra para el hilo actual
+     * @return Bloque del hilo
+     */
+    static MetricasHilo* registrarHilo() {
+        pthread_key_t k = clave();
+        pthread_mutex_lock(candado());
+        MetricasHilo* bloque = libres();
+        if (bloque != NULL) {
+            libres() = bloque->siguiente;
+        } else {
+            pthread_mutex_unlock(candado());
+            bloque = new MetricasHilo();  // Fuera del candado: son 47 KB
+            pthread_mutex_lock(candado());
+        }
+        bloque->siguiente = cabeza();
+        cabeza() = bloque;
+        pthread_mutex_unlock(candado());
+        pthread_setspecific(k, bloque);
+        return bloque;
+    }
+    
+    /**
+     * @brief Cuantas marcas del contador caben en un nanosegundo
+     * 
+     * Calibro el TSC contra el reloj monotono una sola vez
+     */
+    static double marcasPorNs() {
+        static double factor = 0.0;
+        if (factor == 0.0) {
+            long long ns0 = relojNs();
+            unsigned long long m0 = marcaMetricas();
+            usleep(20000);
+            long long ns1 = relojNs();
+            unsigned long long m1 = marcaMetricas();
+            factor = (double)(m1 - m0) / (double)(ns1 - ns0);
+            if (factor <= 0.0) factor = 1.0;
+        }
+        return factor;
+    }
+
+public:
+    /**
+     * @brief Interruptor en tiempo de ejecucion (para medir el propio costo)
+     * @return Referencia a la bandera
+     */
+    static bool& activas() {
+        static bool activo = true;
+        return activo;
+    }
+    
+    /**
+     * @brief Cuentas sin publicar del hilo actual
+     * @return Referencia a las del hilo
+     */
+    static MetricasLocales& locales() {
+        static thread_local MetricasLocales propias = { { 0 }, { false }, NULL };
+        return propias;
+    }
+    
+    /**
+     * @brief Publica en el bloque del hilo las llamadas contadas de una operacion
+     * 
+     * Es el camino lento de MedidorOperacion: corre cuando faltan bajo de
+     * 0, o sea cada MUESTREO_METRICAS llamadas (la primera vez, en la
+     * primera llamada). El bloque se crea aqui la primera vez.
+     * 
+     * @param op Operacion
+     * @return Bloque del hilo (para registrar la latencia)
+     */
+    static MetricasHilo* __attribute__((noinline)) publicar(int op) {
+        MetricasLocales& propias = locales();
+        if (propias.bloque == NULL) propias.bloque = registrarHilo();
+        propias.bloque->publicar(op, propias.empezada[op] ? MUESTREO_METRICAS : 1);
+        propias.empezada[op] = true;
+        propias.faltan[op] = MUESTREO_METRICAS - 1;
+        return propias.bloque;
+    }
+    
+    /**
+     * @brief Suma los bloques de todos los hilos en uno solo
+     * @param total Bloque destino (se sobreescribe)
+     */
+    static void combinar(MetricasHilo& total) {
+        memset(total.conteo, 0, sizeof(total.conteo));
+        for (int op = 0; op < OP_CANTIDAD; op++) total.latencia[op].reiniciar();
+        
+        // Los otros hilos pueden seguir escribiendo: el reporte es aproximado
+        pthread_mutex_lock(candado());
+        retirados().sumarA(total);
+        for (MetricasHilo* h = cabeza(); h != NULL; h = h->siguiente) h->sumarA(total);
+        pthread_mutex_unlock(candado());
+        
+        // Lo que el hilo que pregunta no ha publicado si lo puedo contar exacto
+        const MetricasLocales& propias = locales();
+        for (int op = 0; op < OP_CANTIDAD; op++) total.conteo[op] += propias.pendientes(op);
+    }
+    
+    /**
+     * @brief Imprime operaciones, percentiles y memoria contada
+     */
+    static void imprimirReporte() {
+        static const char* nombres[OP_CANTIDAD] = {
+            "insertarAlFinal", "insertarLote", "buscarSensor",
+            "eliminarMasBajo", "calcularPromedio", "procesarTodos"
+        };
+        MetricasHilo* total = new MetricasHilo();
+        combinar(*total);
+        double factor = marcasPorNs();
+        
+        printf("\n=== Reporte de Metricas ===\n");
+        printf("%-18s %12s %10s %10s %10s %10s\n", "Operacion", "Llamadas", "p50 ns", "p99 ns", "p999 ns", "max ns");
+        for (int op = 0; op < OP_CANTIDAD; op++) {
+            const HistogramaLatencia& h = total->latencia[op];
+            printf("%-18s %12lld %10.0f %10.0f %10.0f %10.0f\n", nombres[op], total->conteo[op],
+                   h.percentil(50) / factor, h.percentil(99) / factor,
+                   h.percentil(99.9) / factor, h.obtenerMaximo() / factor);
+        }
+        printf("Asignaciones: %lld, liberaciones: %lld, bytes vivos: %lld (pico %lld)\n",
+               ContadorMemoria::asignaciones(), ContadorMemoria::liberaciones(),
+               ContadorMemoria::bytesVivos(), ContadorMemoria::picoBytes());
+        printf("(Latencia muestreada 1 de cada %u llamadas; los demas hilos publican sus cuentas con la misma frecuencia)\n",
+               MUESTREO_METRICAS);
+        delete total;
+    }
+};
+
+/**
+ * @brief Mide una operacion desde que se construye hasta que sale de alcance
+ */
+class MedidorOperacion {
+private:
+    MetricasHilo* bloque;
+    int operacion;
+    unsigned long long inicio;  // 0 si esta llamada no se muestrea
+
+public:
+    /**
+     * @brief Cuenta la llamada y, si toca muestrear, publica y toma la marca inicial
+     * 
+     * El caso comun es restar 1 a una variable del hilo; lo demas pasa 1
+     * de cada MUESTREO_METRICAS veces.
+     * 
+     * @param op Operacion que se mide
+     */
+    MedidorOperacion(int op) : bloque(NULL), operacion(op), inicio(0) {
+        if (!Metricas::activas()) return;
+        if (__builtin_expect(--Metricas::locales().faltan[op] < 0, 0)) {
+            bloque = Metricas::publicar(op);
+            inicio = marcaMetricas();
+        }
+    }
+    
+    /**
+     * @brief Registra la duracion si esta llamada se muestreo
+     */
+    ~MedidorOperacion() {
+        if (inicio != 0) {
+            bloque->latencia[operacion].registrar((long long)(marcaMetricas() - inicio));
+        }
+    }
+};
+
+#define METRICAS_CONCAT_(a, b) a##b
+#define METRICAS_CONCAT(a, b) METRICAS_CONCAT_(a, b)
+
+/** @brief Mide la operacion hasta el final del bloque actual */
+#define MEDIR_OPERACION(op) MedidorOperacion METRICAS_CONCAT(medidor_, __LINE__)(op)
+
+#else  // SENSORES_METRICAS == 0: todo desaparece
+
+#include <cstdio>  // Para printf
+
+#define MEDIR_OPERACION(op) do {} while (0)
+
+/**
+ * @brief Version vacia para cuando las metricas estan compiladas fuera
+ */
+class Metricas {
+public:
+    /**
+     * @brief Siempre apagadas
+     * @return Referencia a la bandera
+     */
+    static bool& activas() {
+        static bool activo = false;
+        return activo;
+    }
+    
+    /**
+     * @brief Avisa que no hay nada que reportar
+     */
+    static void imprimirReporte() {
+        printf("\n[Metricas] Compilado sin metricas (SENSORES_METRICAS=0).\n");
+    }
+};
+
+#endif // SENSORES_METRICAS
+
+#endif // METRICAS_H
\ No newline at end of file
@@ -0,0 +1,360 @@
+#ifndef PIPELINE_INGESTA_H
+#define PIPELINE_INGESTA_H
+
+#include <cstdio>    // Para printf (C puro, sin STL)
+#include <cstdlib>   // Para malloc, free
+#include <cstring>   // Para memset
+#include <pthread.h> // Hilos POSIX (C puro)
+#include <sched.h>   // Para sched_yield
+#include "SensorBase.h"
+#include "ColaSPSC.h"
+#include "HistogramaLatencia.h"
+#include "Reloj.h"
+
+/**
+ * @brief Una lectura que viaja por el pipeline
+ */
+struct LecturaPendiente {
+    SensorBase* sensor;  // Sensor destino
+    double valor;        // Valor leido (se convierte al tipo del sensor al aplicarse)
+    long long marcaNs;   // Momento en que se publico, para medir la latencia
+};
+
+/**
+ * @brief Parametros del pipeline de ingesta
+ */
+struct ConfigPipeline {
+    int productores;           // Cuantos hilos de adquisicion (uno por carril)
+    int capacidadCarril;       // Lecturas que aguanta cada carril antes de frenar al productor
+                               // (unos pocos lotes: mas solo agrega espera en la cola)
+    int tamanioLote;           // Maximo de lecturas que agrupo antes de aplicar
+    long long esperaMaximaNs;  // Tiempo maximo que una lectura espera a que se llene su lote
+    
+    /**
+     * @brief Constructor con valores razonables para un gateway
+     */
+    ConfigPipeline() : productores(1), capacidadCarril(4096), tamanioLote(1024), esperaMaximaNs(200000) {}
+};
+
+/**
+ * @brief Pipeline asincrono: productores -> agrupador -> historiales
+ * 
+ * Cada hilo de adquisicion publica en su propio carril (una ColaSPSC sin
+ * candados). Un hilo agrupador junta lecturas de todos los carriles hasta
+ * llenar un lote o vencer la espera maxima, las agrupa por sensor y hace
+ * una sola insercion en bloque por sensor. Si un carril se llena el
+ * productor espera (contrapresion) en lugar de perder lecturas.
+ * 
+ * Hay un solo aplicador a proposito: la cola de sucios de ListaGestion no
+ * es segura entre hilos, asi que todas las escrituras a los sensores pasan
+ * por el mismo hilo. Mientras el pipeline corre no se debe llamar a
+ * procesarTodos; primero se usa vaciar().
+ */
+class PipelineIngesta {
+private:
+    /**
+     * @brief Estado de un carril; el relleno evita compartir linea de cache
+     */
+    struct Carril {
+        ColaSPSC<LecturaPendiente>* cola;
+        long long publicadas;  // Lo escribe solo su productor
+        long long bloqueos;    // Veces que el productor encontro la cola llena
+        char relleno[64];
+    };
+    
+    ConfigPipeline config;
+    Carril* carriles;
+    
+    // Lote en construccion (solo lo toca el hilo agrupador)
+    LecturaPendiente* lote;
+    int enLote;
+    
+    // Tabla hash para agrupar por sensor sin STL
+    SensorBase** tablaSensores;  // Llave: puntero al sensor (NULL = libre)
+    int* tablaGrupo;             // Grupo asignado a esa llave
+    unsigned mascaraTabla;
+    int* grupoDeLectura;         // Grupo de cada lectura del lote
+    SensorBase** sensorDeGrupo;
+    int* cuentaDeGrupo;
+    int* posicionDeGrupo;
+    int* ranuraDeGrupo;          // Donde quedo el grupo en la tabla (para limpiarla)
+    double* valoresAgrupados;
+    
+    pthread_t hilo;
+    bool corriendo;
+    bool iniciado;
+    
+    long long aplicadas;  // Lecturas ya en los historiales
+    long long lotes;      // Lotes aplicados
+    HistogramaLatencia latencias;
+    
+    // No se copia: maneja un hilo y memoria propia
+    PipelineIngesta(const PipelineIngesta&);
+    PipelineIngesta& operator=(const PipelineIngesta&);
+    
+    /**
+     * @brief Funcion de arranque del hilo agrupador
+     * @param arg Puntero al pipeline
+     * @return Siempre NULL
+     */
+    static void* arrancarAgrupador(void* arg) {
+        ((PipelineIngesta*)arg)->cicloAgrupador();
+        return NULL;
+    }
+    
+    /**
+     * @brief Saca lecturas de todos los carriles hasta llenar el lote
+     * @return Cuantas lecturas saque en esta vuelta
+     */
+    int recolectar() {
+        int sacadas = 0;
+        for (int c = 0; c < config.productores && enLote < config.tamanioLote; c++) {
+            int n = carriles[c].cola->extraerVarios(lote + enLote, config.tamanioLote - enLote);
+            enLote += n;
+            sacadas += n;
+        }
+        return sacadas;
+    }
+    
+    /**
+     * @brief Agrupa el lote por sensor y lo aplica con una insercion por sensor
+     */
+    void aplicarLote() {
+        if (enLote == 0) return;
+        
+        // 1) Asigno un grupo a cada sensor distinto del lote
+        int grupos = 0;
+        for (int i = 0; i < enLote; i++) {
+            SensorBase* sensor = lote[i].sensor;
+            unsigned long long llave = (unsigned long long)sensor;
+            unsigned ranura = (unsigned)((llave >> 4) * 0x9E3779B97F4A7C15ULL >> 32) & mascaraTabla;
+            while (tablaSensores[ranura] != NULL && tablaSensores[ranura] != sensor) {
+                ranura = (ranura + 1) & mascaraTabla;  // Sondeo lineal
+            }
+            if (tablaSensores[ranura] == NULL) {
+                tablaSensores[ranura] = sensor;
+                tablaGrupo[ranura] = grupos;
+                sensorDeGrupo[grupos] = sensor;
+                cuentaDeGrupo[grupos] = 0;
+                ranuraDeGrupo[grupos] = ranura;
+                grupos++;
+            }
+            int g = tablaGrupo[ranura];
+            grupoDeLectura[i] = g;
+            cuentaDeGrupo[g]++;
+        }
+        
+        // 2) Acomodo los valores contiguos por grupo (conservando el orden de llegada)
+        int acumulado = 0;
+        for (int g = 0; g < grupos; g++) {
+            posicionDeGrupo[g] = acumulado;
+            acumulado += cuentaDeGrupo[g];
+        }
+        for (int i = 0; i < enLote; i++) {
+            valoresAgrupados[posicionDeGrupo[grupoDeLectura[i]]++] = lote[i].valor;
+        }
+        
+        // 3) Una insercion en bloque por sensor
+        for (int g = 0; g < grupos; g++) {
+            int inicioGrupo = posicionDeGrupo[g] - cuentaDeGrupo[g];
+            sensorDeGrupo[g]->registrarLote(valoresAgrupados + inicioGrupo, cuentaDeGrupo[g]);
+            tablaSensores[ranuraDeGrupo[g]] = NULL;  // Dejo la tabla limpia para el siguiente lote
+        }
+        
+        // 4) Latencia de punta a punta de cada lectura
+        long long ahora = relojNs();
+        for (int i = 0; i < enLote; i++) {
+            latencias.registrar(ahora - lote[i].marcaNs);
+        }
+        
+        lotes++;
+        __atomic_store_n(&aplicadas, aplicadas + enLote, __ATOMIC_RELEASE);
+        enLote = 0;
+    }
+    
+    /**
+     * @brief Ciclo principal del hilo agrupador
+     */
+    void cicloAgrupador() {
+        while (true) {
+            // Leo la bandera ANTES de recolectar: si ya me pidieron parar,
+            // todo lo publicado antes de eso ya es visible en los carriles
+            bool seguir = __atomic_load_n(&corriendo, __ATOMIC_ACQUIRE);
+            int sacadas = recolectar();
+            
+            if (enLote >= config.tamanioLote) {
+                aplicarLote();  // Lote lleno
+            } else if (enLote > 0 && relojNs() - lote[0].marcaNs >= config.esperaMaximaNs) {
+                aplicarLote();  // La lectura mas vieja ya espero suficiente
+            }
+            
+            if (sacadas == 0) {
+                if (!seguir) break;
+                sched_yield();  // No hay nada, le doy chance a los productores
+            }
+        }
+        aplicarLote();  // Lo que haya quedado a medias
+    }
+
+public:
+    /**
+     * @brief Constructor que reserva carriles y buffers del agrupador
+     * @param cfg Parametros del pipeline
+     */
+    PipelineIngesta(const ConfigPipeline& cfg) : config(cfg), enLote(0), corriendo(false),
+                                                 iniciado(false), aplicadas(0), lotes(0) {
+        if (config.productores < 1) config.productores = 1;
+        if (config.tamanioLote < 1) config.tamanioLote = 1;
+        
+        carriles = (Carril*)malloc(sizeof(Carril) * config.productores);
+        for (int c = 0; c < config.productores; c++) {
+            carriles[c].cola = new ColaSPSC<LecturaPendiente>(config.capacidadCarril);
+            carriles[c].publicadas = 0;
+            carriles[c].bloqueos = 0;
+        }
+        
+        int n = config.tamanioLote;
+        unsigned capacidadTabla = 2;
+        while (capacidadTabla < (unsigned)n * 2) capacidadTabla <<= 1;
+        mascaraTabla = capacidadTabla - 1;
+        
+        lote = (LecturaPendiente*)malloc(sizeof(LecturaPendiente) * n);
+        tablaSensores = (SensorBase**)calloc(capacidadTabla, sizeof(SensorBase*));
+        tablaGrupo = (int*)malloc(sizeof(int) * capacidadTabla);
+        grupoDeLectura = (int*)malloc(sizeof(int) * n);
+        sensorDeGrupo = (SensorBase**)malloc(sizeof(SensorBase*) * n);
+        cuentaDeGrupo = (int*)malloc(sizeof(int) * n);
+        posicionDeGrupo = (int*)malloc(sizeof(int) * n);
+        ranuraDeGrupo = (int*)malloc(sizeof(int) * n);
+        valoresAgrupados = (double*)malloc(sizeof(double) * n);
+    }
+    
+    /**
+     * @brief Destructor que detiene el hilo y libera todo
+     */
+    ~PipelineIngesta() {
+        detener();
+        for (int c = 0; c < config.productores; c++) {
+            delete carriles[c].cola;
+        }
+        free(carriles);
+        free(lote);
+        free(tablaSensores);
+        free(tablaGrupo);
+        free(grupoDeLectura);
+        free(sensorDeGrupo);
+        free(cuentaDeGrupo);
+        free(posicionDeGrupo);
+        free(ranuraDeGrupo);
+        free(valoresAgrupados);
+    }
+    
+    /**
+     * @brief Arranca el hilo agrupador
+     * @return true si el hilo arranco
+     */
+    bool iniciar() {
+        if (iniciado) return true;
+        __atomic_store_n(&corriendo, true, __ATOMIC_RELEASE);
+        if (pthread_create(&hilo, NULL, arrancarAgrupador, this) != 0) {
+            corriendo = false;
+            printf("[Pipeline] Error: no pude crear el hilo agrupador.\n");
+            return false;
+        }
+        iniciado = true;
+        return true;
+    }
+    
+    /**
+     * @brief Pide al agrupador que termine y espera a que aplique todo lo pendiente
+     */
+    void detener() {
+        if (!iniciado) return;
+        __atomic_store_n(&corriendo, false, __ATOMIC_RELEASE);
+        pthread_join(hilo, NULL);
+        iniciado = false;
+    }
+    
+    /**
+     * @brief Publica una lectura desde el hilo productor indicado
+     * 
+     * Si el carril esta lleno espero a que el agrupador libere espacio.
+     * Cada carril debe usarse desde un solo hilo. Antes de iniciar() y
+     * despues de detener() la lectura se rechaza.
+     * 
+     * @param productor Numero de carril (0 .. productores-1)
+     * @param sensor Sensor destino
+     * @param valor Lectura
+     * @return false si el pipeline no esta corriendo
+     */
+    bool publicar(int productor, SensorBase* sensor, double valor) {
+        if (!__atomic_load_n(&corriendo, __ATOMIC_ACQUIRE)) return false;
+        LecturaPendiente lectura;
+        lectura.sensor = sensor;
+        lectura.valor = valor;
+        lectura.marcaNs = relojNs();
+        
+        Carril& carril = carriles[productor];
+        if (!carril.cola->intentarEncolar(lectura)) {
+            carril.bloqueos++;
+            do {
+                if (!__atomic_load_n(&corriendo, __ATOMIC_ACQUIRE)) return false;
+                sched_yield();
+            } while (!carril.cola->intentarEncolar(lectura));
+        }
+        __atomic_store_n(&carril.publicadas, carril.publicadas + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    
+    /**
+     * @brief Espera a que todo lo publicado hasta ahora este en los historiales
+     * 
+     * Se llama cuando los productores ya terminaron (o estan en pausa).
+     * Si el agrupador no corre (antes de iniciar, despues de detener o si
+     * no se pudo crear su hilo) nadie mas va a aplicar: lo aplico aqui.
+     */
+    void vaciar() {
+        if (!iniciado) {
+            while (recolectar() > 0) aplicarLote();
+            return;
+        }
+        while (true) {
+            long long publicadas = 0;
+            for (int c = 0; c < config.productores; c++) {
+                publicadas += __atomic_load_n(&carriles[c].publicadas, __ATOMIC_ACQUIRE);
+            }
+            if (__atomic_load_n(&aplicadas, __ATOMIC_ACQUIRE) >= publicadas) return;
+            sched_yield();
+        }
+    }
+    
+    /**
+     * @brief Histograma de latencias de punta a punta (en ns)
+     * 
+     * Solo es confiable despues de detener()
+     * 
+     * @return Referencia al histograma
+     */
+    const HistogramaLatencia& obtenerLatencias() const {
+        return latencias;
+    }
+    
+    /**
+     * @brief Muestra contadores y percentiles de latencia
+     */
+    void imprimirReporte() const {
+        long long bloqueos = 0;
+        for (int c = 0; c < config.productores; c++) {
+            bloqueos += carriles[c].bloqueos;
+        }
+        printf("[Pipeline] Lecturas aplicadas: %lld en %lld lotes (%.1f por lote)\n",
+               aplicadas, lotes, lotes == 0 ? 0.0 : (double)aplicadas / lotes);
+        printf("[Pipeline] Carriles: %d, lote max: %d, espera max: %lld us, contrapresion: %lld veces\n",
+               config.productores, config.tamanioLote, config.esperaMaximaNs / 1000, bloqueos);
+        printf("[Pipeline] Latencia p50: %.1f us, p99: %.1f us, p99.9: %.1f us, max: %.1f us\n",
+               latencias.percentil(50) / 1000.0, latencias.percentil(99) / 1000.0,
+               latencias.percentil(99.9) / 1000.0, latencias.obtenerMaximo() / 1000.0);
+    }
+};
+
+#endif // PIPELINE_INGESTA_H
\ No newline at end of file
@@ -0,0 +1,656 @@
+#ifndef PLANIFICADOR_DISPOSITIVOS_H
+#define PLANIFICADOR_DISPOSITIVOS_H
+
+/**
+ * @file PlanificadorDispositivos.h
+ * @brief Muchos dispositivos simulados atendidos con corrutinas sobre epoll
+ * 
+ * Necesita C++20 (corrutinas). Compilado con un estandar anterior el
+ * archivo queda vacio y PLANIFICADOR_DISPONIBLE vale 0, asi que el resto
+ * del sistema sigue compilando en C++11.
+ */
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define PLANIFICADOR_DISPONIBLE 1
+
+#include <coroutine>     // Solo std::coroutine_handle, lo minimo que pide el lenguaje
+#include <cstdio>        // Para printf (C puro, sin STL)
+#include <cstdlib>       // Para malloc, realloc, free, abort, rand_r
+#include <cstring>       // Para memset
+#include <cerrno>        // Para errno
+#include <pthread.h>     // Hilos y candados POSIX (C puro)
+#include <time.h>        // Para clock_gettime
+#include <unistd.h>      // Para read, close
+#include <fcntl.h>       // Para fcntl (O_NONBLOCK)
+#include <sys/epoll.h>   // Para epoll
+#include <sys/timerfd.h> // Para timerfd
+#include "ListaGestion.h"
+#include "ContadorMemoria.h"
+#include "Reloj.h"
+
+class TrabajadorPlanificador;
+
+/**
+ * @brief Corrutina de un dispositivo
+ * 
+ * Arranca suspendida (la lanza su trabajador) y al terminar se destruye
+ * sola; el promise avisa al trabajador para que sepa cuantas le quedan.
+ */
+struct TareaDispositivo {
+    struct promise_type {
+        int* vivas;  // Contador de tareas del trabajador (NULL mientras no tenga)
+        
+        promise_type() : vivas(NULL) {}
+        
+        /**
+         * @brief Avisa al trabajador que la tarea termino
+         */
+        ~promise_type() {
+            if (vivas != NULL) (*vivas)--;
+        }
+        
+        TareaDispositivo get_return_object() {
+            return TareaDispositivo(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { abort(); }  // El sistema no usa excepciones
+        
+        /**
+         * @brief El marco de la corrutina se pide al contador global
+         * @param bytes Tamanio del marco
+         * @return Memoria para el marco
+         */
+        static void* operator new(size_t bytes) {
+            return ContadorMemoria::pedir(bytes);
+        }
+        
+        /**
+         * @brief Devuelve el marco al contador global
+         * @param p Memoria del marco
+         * @param bytes Tamanio con el que se pidio
+         */
+        static void operator delete(void* p, size_t bytes) {
+            ContadorMemoria::devolver(p, bytes);
+        }
+    };
+    
+    std::coroutine_handle<promise_type> manija;
+    
+    /**
+     * @brief Constructor a partir de la manija de la corrutina
+     * @param m Manija
+     */
+    explicit TareaDispositivo(std::coroutine_handle<promise_type> m) : manija(m) {}
+};
+
+/**
+ * @brief Un despertador pendiente en el monticulo de un trabajador
+ */
+struct EventoTemporizador {
+    long long venceNs;  // Momento (reloj monotono) en que hay que despertar
+    void* manija;       // Corrutina a reanudar
+};
+
+/**
+ * @brief Un hilo del planificador: su propio epoll, timerfd y tareas
+ * 
+ * Cada tarea vive siempre en el mismo trabajador, asi que reanudarla no
+ * necesita candados. El timerfd se programa con el vencimiento mas
+ * cercano del monticulo de despertadores.
+ */
+class TrabajadorPlanificador {
+private:
+    int epollFd;
+    int temporizadorFd;
+    EventoTemporizador* monticulo;  // Monticulo minimo por venceNs
+    int enMonticulo;
+    int capacidadMonticulo;
+    void** pendientes;              // Tareas por arrancar (manijas)
+    int* fdsPendientes;             // fd de cada tarea pendiente, -1 si no tiene
+    int cantidadPendientes;
+    int capacidadPendientes;
+    bool arrancado;
+    pthread_t hilo;
+    
+    /**
+     * @brief Trabajador del hilo actual (lo usan los awaiters)
+     * @return Referencia al apuntador del hilo
+     */
+    static TrabajadorPlanificador*& actualRef() {
+        static thread_local TrabajadorPlanificador* actual = NULL;
+        return actual;
+    }
+    
+    /**
+     * @brief Programa el timerfd con el vencimiento mas cercano
+     */
+    void reprogramar() {
+        struct itimerspec cuando;
+        memset(&cuando, 0, sizeof(cuando));
+        if (enMonticulo > 0) {
+            long long vence = monticulo[0].venceNs;
+            if (vence <= 0) vence = 1;  // Cero desarmaria el timer
+            cuando.it_value.tv_sec = vence / 1000000000LL;
+            cuando.it_value.tv_nsec = vence % 1000000000LL;
+        }
+        timerfd_settime(temporizadorFd, TFD_TIMER_ABSTIME, &cuando, NULL);
+    }
+    
+    /**
+     * @brief Saca el despertador mas proximo del monticulo
+     * @return El evento que estaba arriba
+     */
+    EventoTemporizador sacarMinimo() {
+        EventoTemporizador arriba = monticulo[0];
+        monticulo[0] = monticulo[--enMonticulo];
+        int i = 0;
+        for (;;) {
+            int hijo = 2 * i + 1;
+            if (hijo >= enMonticulo) break;
+            if (hijo + 1 < enMonticulo && monticulo[hijo + 1].venceNs < monticulo[hijo].venceNs) hijo++;
+            if (monticulo[i].venceNs <= monticulo[hijo].venceNs) break;
+            EventoTemporizador t = monticulo[i];
+            monticulo[i] = monticulo[hijo];
+            monticulo[hijo] = t;
+            i = hijo;
+        }
+        return arriba;
+    }
+    
+    /**
+     * @brief Reanuda las tareas cuyo despertador ya vencio
+     * 
+     * Solo atiendo las que ya estaban en el monticulo al entrar: una tarea
+     * que se vuelve a dormir con vencimiento inmediato espera a la
+     * siguiente vuelta y no acapara el hilo.
+     */
+    void despertarVencidos() {
+        long long ahora = relojNs();
+        int revisar = enMonticulo;
+        while (revisar-- > 0 && enMonticulo > 0 && monticulo[0].venceNs <= ahora) {
+            EventoTemporizador evento = sacarMinimo();
+            despertares++;
+            std::coroutine_handle<>::from_address(evento.manija).resume();
+        }
+        reprogramar();
+    }
+    
+    /**
+     * @brief Ciclo de eventos del trabajador
+     */
+    void correr() {
+        actualRef() = this;
+        struct timespec cpu0;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
+        
+        // Cada tarea corre hasta su primera espera
+        for (int i = 0; i < cantidadPendientes; i++) {
+            despertares++;
+            std::coroutine_handle<>::from_address(pendientes[i]).resume();
+        }
+        cantidadPendientes = 0;
+        
+        struct epoll_event eventos[256];
+        while (vivas > 0) {
+            int n = epoll_wait(epollFd, eventos, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                printf("[Planificador] Error en epoll_wait.\n");
+                break;
+            }
+            esperas++;
+            for (int i = 0; i < n; i++) {
+                if (eventos[i].data.ptr == NULL) {
+                    unsigned long long vencidos;
+                    if (read(temporizadorFd, &vencidos, sizeof(vencidos)) < 0) { /* Ya no hay nada que leer */ }
+                    despertarVencidos();
+                } else {
+                    despertares++;
+                    std::coroutine_handle<>::from_address(eventos[i].data.ptr).resume();
+                }
+            }
+        }
+        
+        struct timespec cpu1;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
+        cpuNs = (cpu1.tv_sec - cpu0.tv_sec) * 1000000000LL + (cpu1.tv_nsec - cpu0.tv_nsec);
+        actualRef() = NULL;
+    }
+    
+    /**
+     * @brief Funcion de arranque del hilo
+     * @param arg Apuntador al trabajador
+     * @return Siempre NULL
+     */
+    static void* arrancar(void* arg) {
+        ((TrabajadorPlanificador*)arg)->correr();
+        return NULL;
+    }
+    
+    // No se copia: maneja descriptores y un hilo
+    TrabajadorPlanificador(const TrabajadorPlanificador&);
+    TrabajadorPlanificador& operator=(const TrabajadorPlanificador&);
+
+public:
+    int vivas;              // Tareas que no han terminado
+    long long despertares;  // Veces que reanude una tarea
+    long long esperas;      // Vueltas de epoll_wait con eventos
+    long long cpuNs;        // Tiempo de CPU del hilo en su ciclo
+    
+    /**
+     * @brief Constructor que crea el epoll y el timerfd del trabajador
+     */
+    TrabajadorPlanificador()
+        : monticulo(NULL), enMonticulo(0), capacidadMonticulo(0), pendientes(NULL),
+          fdsPendientes(NULL), cantidadPendientes(0), capacidadPendientes(0), arrancado(false),
+          vivas(0), despertares(0), esperas(0), cpuNs(0) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        temporizadorFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        struct epoll_event evento;
+        memset(&evento, 0, sizeof(evento));
+        evento.events = EPOLLIN;
+        evento.data.ptr = NULL;  // NULL identifica al timerfd
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, temporizadorFd, &evento);
+    }
+    
+    /**
+     * @brief Destructor; si nunca arranco, destruye las tareas y cierra sus fds
+     */
+    ~TrabajadorPlanificador() {
+        for (int i = 0; i < cantidadPendientes; i++) {
+            std::coroutine_handle<>::from_address(pendientes[i]).destroy();
+            if (fdsPendientes[i] >= 0) close(fdsPendientes[i]);
+        }
+        free(pendientes);
+        free(fdsPendientes);
+        free(monticulo);
+        close(temporizadorFd);
+        close(epollFd);
+    }
+    
+    /**
+     * @brief Trabajador que esta corriendo en este hilo
+     * @return Apuntador al trabajador, NULL fuera del planificador
+     */
+    static TrabajadorPlanificador* actual() {
+        return actualRef();
+    }
+    
+    /**
+     * @brief Asigna una tarea a este trabajador (antes de arrancar)
+     * @param tarea Corrutina recien creada (suspendida)
+     * @param fd Descriptor a vigilar, -1 si la tarea solo usa el reloj
+     * @return true si se pudo registrar
+     */
+    bool agregar(TareaDispositivo tarea, int fd) {
+        if (fd >= 0) {
+            // Una sola alta por fd, disparo por flanco: la tarea lee hasta EAGAIN
+            struct epoll_event evento;
+            memset(&evento, 0, sizeof(evento));
+            evento.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+            evento.data.ptr = tarea.manija.address();
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &evento) != 0) {
+                tarea.manija.destroy();
+                return false;
+            }
+        }
+        if (cantidadPendientes == capacidadPendientes) {
+            capacidadPendientes = capacidadPendientes == 0 ? 64 : capacidadPendientes * 2;
+            pendientes = (void**)realloc(pendientes, sizeof(void*) * capacidadPendientes);
+            fdsPendientes = (int*)realloc(fdsPendientes, sizeof(int) * capacidadPendientes);
+        }
+        tarea.manija.promise().vivas = &vivas;
+        pendientes[cantidadPendientes] = tarea.manija.address();
+        fdsPendientes[cantidadPendientes] = fd;
+        cantidadPendientes++;
+        vivas++;
+        return true;
+    }
+    
+    /**
+     * @brief Duerme una tarea hasta cierto momento
+     * @param venceNs Momento en el reloj monotono
+     * @param manija Corrutina a reanudar
+     */
+    void programar(long long venceNs, void* manija) {
+        if (enMonticulo == capacidadMonticulo) {
+            capacidadMonticulo = capacidadMonticulo == 0 ? 64 : capacidadMonticulo * 2;
+            monticulo = (EventoTemporizador*)realloc(monticulo, sizeof(EventoTemporizador) * capacidadMonticulo);
+        }
+        int i = enMonticulo++;
+        monticulo[i].venceNs = venceNs;
+        monticulo[i].manija = manija;
+        while (i > 0 && monticulo[(i - 1) / 2].venceNs > monticulo[i].venceNs) {
+            EventoTemporizador t = monticulo[i];
+            monticulo[i] = monticulo[(i - 1) / 2];
+            monticulo[(i - 1) / 2] = t;
+            i = (i - 1) / 2;
+        }
+        if (i == 0) reprogramar();  // Es el nuevo mas proximo
+    }
+    
+    /**
+     * @brief Lanza el hilo del trabajador
+     * @return true si se creo el hilo
+     */
+    bool iniciar() {
+        arrancado = pthread_create(&hilo, NULL, arrancar, this) == 0;
+        return arrancado;
+    }
+    
+    /**
+     * @brief Espera a que terminen todas las tareas del trabajador
+     */
+    void esperar() {
+        if (arrancado) pthread_join(hilo, NULL);
+        arrancado = false;
+    }
+};
+
+/**
+ * @brief Espera a que el fd de la tarea tenga datos (o se cierre)
+ * 
+ * El fd ya esta dado de alta en el epoll del trabajador con la manija de
+ * la tarea, asi que aqui solo hay que suspenderse.
+ */
+struct EsperarDatos {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Duerme la tarea hasta un momento del reloj monotono
+ */
+struct DormirHasta {
+    long long venceNs;
+    
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> manija) const noexcept {
+        TrabajadorPlanificador::actual()->programar(venceNs, manija.address());
+    }
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Planificador de dispositivos simulados sobre un grupo chico de hilos
+ * 
+ * Cada dispositivo es una corrutina que espera datos en un fd (pipe o
+ * pty, con epoll) o un despertador (timerfd) y entrega sus lecturas al
+ * sensor que le toca en la ListaGestion. Los dispositivos se reparten
+ * entre los trabajadores al agregarlos; cada trabajador tiene su propio
+ * ciclo de eventos.
+ * 
+ * Los sensores se alimentan con registrarLote bajo un candado comun
+ * (uno por rafaga, no por lectura), porque la cola de sucios de la
+ * ListaGestion no es segura entre hilos. No se debe llamar a
+ * procesarTodos mientras corre().
+ */
+class PlanificadorDispositivos {
+private:
+    ListaGestion& sistema;
+    TrabajadorPlanificador* trabajadores;
+    int hilos;
+    int siguiente;           // Trabajador que recibe el proximo dispositivo
+    pthread_mutex_t candado; // Protege los sensores y la cola de sucios
+    long long lecturas;      // Lecturas entregadas (bajo el candado)
+    long long entregas;      // Llamadas a registrarLote
+    long long lineasInvalidas;
+    
+    // No se copia: maneja hilos y descriptores
+    PlanificadorDispositivos(const PlanificadorDispositivos&);
+    PlanificadorDispositivos& operator=(const PlanificadorDispositivos&);
+    
+    /**
+     * @brief Convierte una linea de texto del dispositivo a numero
+     * 
+     * Formato del puerto serial del Arduino: "-12.34" sin exponentes.
+     * 
+     * @param texto Inicio de la linea
+     * @param largo Caracteres de la linea (sin el salto)
+     * @param valor Salida
+     * @return true si la linea era un numero
+     */
+    static bool convertirLinea(const char* texto, int largo, double& valor) {
+        int i = 0;
+        bool negativo = false;
+        if (i < largo && (texto[i] == '-' || texto[i] == '+')) negativo = texto[i++] == '-';
+        double entero = 0.0;
+        double fraccion = 0.0;
+        double escala = 1.0;
+        int digitos = 0;
+        while (i < largo && texto[i] >= '0' && texto[i] <= '9') {
+            entero = entero * 10.0 + (texto[i++] - '0');
+            digitos++;
+        }
+        if (i < largo && texto[i] == '.') {
+            i++;
+            while (i < largo && texto[i] >= '0' && texto[i] <= '9') {
+                fraccion = fraccion * 10.0 + (texto[i++] - '0');
+                escala *= 10.0;
+                digitos++;
+            }
+        }
+        while (i < largo && (texto[i] == '\r' || texto[i] == ' ')) i++;
+        if (digitos == 0 || i != largo) return false;
+        valor = entero + fraccion / escala;
+        if (negativo) valor = -valor;
+        return true;
+    }
+    
+    /**
+     * @brief Pasa lecturas al sensor bajo el candado comun
+     * @param sensor Sensor destino
+     * @param valores Lecturas
+     * @param cantidad Cuantas
+     */
+    void entregar(SensorBase* sensor, const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        pthread_mutex_lock(&candado);
+        sensor->registrarLote(valores, cantidad);
+        lecturas += cantidad;
+        entregas++;
+        pthread_mutex_unlock(&candado);
+    }
+    
+    /**
+     * @brief Corrutina de un dispositivo que escribe lineas de texto en un fd
+     * 
+     * Lee todo lo disponible, arma lineas, convierte y entrega por rafaga;
+     * cuando el fd ya no tiene datos se suspende hasta que epoll avise.
+     * Termina al llegar al fin del archivo (el dispositivo se desconecto).
+     * 
+     * @param fd Descriptor no bloqueante (lado de lectura)
+     * @param sensor Sensor que recibe las lecturas
+     * @return La tarea
+     */
+    TareaDispositivo tareaFd(int fd, SensorBase* sensor) {
+        char bloque[512];
+        char linea[64];
+        int largo = 0;
+        double valores[128];
+        int enEspera = 0;
+        
+        for (;;) {
+            ssize_t leidos = read(fd, bloque, sizeof(bloque));
+            if (leidos > 0) {
+                for (ssize_t i = 0; i < leidos; i++) {
+                    char c = bloque[i];
+                    if (c != '\n') {
+                        if (largo < (int)sizeof(linea)) linea[largo] = c;
+                        largo++;
+                        continue;
+                    }
+                    double valor;
+                    if (largo <= (int)sizeof(linea) && convertirLinea(linea, largo, valor)) {
+                        valores[enEspera++] = valor;
+                        if (enEspera == 128) {
+                            entregar(sensor, valores, enEspera);
+                            enEspera = 0;
+                        }
+                    } else {
+                        __atomic_add_fetch(&lineasInvalidas, 1, __ATOMIC_RELAXED);
+                    }
+                    largo = 0;
+                }
+                continue;
+            }
+            if (leidos < 0 && errno == EINTR) continue;
+            if (leidos < 0 && errno == EAGAIN) {
+                // Entrego lo que tengo antes de dormir para no retrasarlo
+                entregar(sensor, valores, enEspera);
+                enEspera = 0;
+                co_await EsperarDatos();
+                continue;
+            }
+            break;  // Fin del archivo o error: el dispositivo se fue
+        }
+        entregar(sensor, valores, enEspera);
+        close(fd);
+    }
+    
+    /**
+     * @brief Corrutina de un dispositivo que se sondea cada cierto tiempo
+     * 
+     * Simula el sondeo al Arduino: despierta cada periodoNs y genera una
+     * lectura con el simulador que registro el tipo del sensor.
+     * 
+     * @param sensor Sensor que recibe las lecturas
+     * @param periodoNs Cada cuanto se lee
+     * @param cantidad Cuantas lecturas en total
+     * @param semilla Semilla del generador
+     * @return La tarea
+     */
+    TareaDispositivo tareaSondeo(SensorBase* sensor, long long periodoNs, int cantidad, unsigned semilla) {
+        const TipoSensor* tipo = RegistroTipos::buscar(sensor->obtenerTipo());
+        double valores[TipoSensor::MAXIMO_CANALES];
+        long long siguienteNs = relojNs();
+        for (int i = 0; i < cantidad; i++) {
+            siguienteNs += periodoNs;
+            co_await DormirHasta{ siguienteNs };
+            if (tipo == NULL) {
+                valores[0] = SimuladorArduino::generarTemperatura(semilla);
+                entregar(sensor, valores, 1);
+            } else {
+                tipo->simular(semilla, valores);
+                entregar(sensor, valores, tipo->canales);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param lista Lista de gestion con los sensores a alimentar
+     * @param cantidadHilos Trabajadores (hilos) del planificador
+     */
+    PlanificadorDispositivos(ListaGestion& lista, int cantidadHilos)
+        : sistema(lista), hilos(cantidadHilos < 1 ? 1 : cantidadHilos), siguiente(0),
+          lecturas(0), entregas(0), lineasInvalidas(0) {
+        trabajadores = new TrabajadorPlanificador[hilos];
+        pthread_mutex_init(&candado, NULL);
+    }
+    
+    /**
+     * @brief Destructor; las tareas que no corrieron se destruyen
+     */
+    ~PlanificadorDispositivos() {
+        delete[] trabajadores;
+        pthread_mutex_destroy(&candado);
+    }
+    
+    /**
+     * @brief Agrega un dispositivo que manda lineas de texto por un fd
+     * 
+     * El planificador se queda con el fd (lo pone no bloqueante y lo
+     * cierra cuando el dispositivo termina).
+     * 
+     * @param idSensor ID del sensor en la lista de gestion
+     * @param fd Lado de lectura de un pipe, pty o socket
+     * @return true si el sensor existe y se pudo registrar el fd
+     */
+    bool agregarDispositivoFd(const char* idSensor, int fd) {
+        SensorBase* sensor = sistema.buscarSensor(idSensor);
+        if (sensor == NULL) return false;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        TrabajadorPlanificador& t = trabajadores[siguiente];
+        siguiente = (siguiente + 1) % hilos;
+        return t.agregar(tareaFd(fd, sensor), fd);
+    }
+    
+    /**
+     * @brief Agrega un dispositivo que se sondea por tiempo
+     * @param idSensor ID del sensor en la lista de gestion
+     * @param periodoNs Cada cuanto se toma una lectura
+     * @param cantidad Lecturas a tomar
+     * @return true si el sensor existe
+     */
+    bool agregarDispositivoSondeo(const char* idSensor, long long periodoNs, int cantidad) {
+        SensorBase* sensor = sistema.buscarSensor(idSensor);
+        if (sensor == NULL) return false;
+        TrabajadorPlanificador& t = trabajadores[siguiente];
+        siguiente = (siguiente + 1) % hilos;
+        return t.agregar(tareaSondeo(sensor, periodoNs, cantidad, hashIdSensor(idSensor)), -1);
+    }
+    
+    /**
+     * @brief Corre todos los dispositivos hasta que terminen
+     */
+    void correr() {
+        for (int i = 0; i < hilos; i++) {
+            if (!trabajadores[i].iniciar()) {
+                printf("[Planificador] No se pudo crear el hilo %d.\n", i);
+            }
+        }
+        for (int i = 0; i < hilos; i++) trabajadores[i].esperar();
+    }
+    
+    /**
+     * @brief Lecturas entregadas a los sensores
+     * @return Total
+     */
+    long long obtenerLecturas() const {
+        return lecturas;
+    }
+    
+    /**
+     * @brief Reanudaciones de tareas en todos los trabajadores
+     * @return Total
+     */
+    long long obtenerDespertares() const {
+        long long total = 0;
+        for (int i = 0; i < hilos; i++) total += trabajadores[i].despertares;
+        return total;
+    }
+    
+    /**
+     * @brief Tiempo de CPU de los trabajadores en su ciclo de eventos
+     * @return Nanosegundos sumados de todos los hilos
+     */
+    long long obtenerCpuNs() const {
+        long long total = 0;
+        for (int i = 0; i < hilos; i++) total += trabajadores[i].cpuNs;
+        return total;
+    }
+    
+    /**
+     * @brief Muestra los contadores del planificador
+     */
+    void imprimirReporte() const {
+        long long esperas = 0;
+        for (int i = 0; i < hilos; i++) esperas += trabajadores[i].esperas;
+        long long despertares = obtenerDespertares();
+        printf("[Planificador] %d hilos, %lld lecturas, %lld entregas, %lld despertares, %lld vueltas de epoll",
+               hilos, lecturas, entregas, despertares, esperas);
+        if (lineasInvalidas > 0) printf(", %lld lineas invalidas", lineasInvalidas);
+        printf("\n");
+    }
+};
+
+#else
+#define PLANIFICADOR_DISPONIBLE 0
+#endif // __cpp_impl_coroutine
+
+#endif // PLANIFICADOR_DISPOSITIVOS_H
\ No newline at end of file
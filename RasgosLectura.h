@@ -0,0 +1,52 @@
+#ifndef RASGOS_LECTURA_H
+#define RASGOS_LECTURA_H
+
+#include <cstddef>  // Para size_t (C puro, sin STL)
+
+/**
+ * @brief Rasgos en tiempo de compilacion de un tipo de lectura
+ * 
+ * ListaSensor los consulta para decidir como guardar y como sumar los
+ * datos. Para un T cualquiera:
+ *  - Si se puede copiar con memcpy, los datos van en bloques contiguos.
+ *  - Las sumas se acumulan en double.
+ * Los enteros se especializan abajo para sumar en long long sin pasar
+ * cada dato a double.
+ * 
+ * @tparam T Tipo de la lectura
+ */
+template <typename T>
+struct RasgosLectura {
+    typedef double Acumulador;  // Tipo en el que sumo para el promedio
+    
+    static constexpr bool EN_BLOQUES = __is_trivially_copyable(T);
+    
+    /** Bytes que quiero por bloque (cuatro lineas de cache) */
+    static constexpr size_t BYTES_BLOQUE = 256;
+    
+    /** Datos por bloque descontando el apuntador y el contador del bloque */
+    static constexpr int DATOS_POR_BLOQUE =
+        (BYTES_BLOQUE - 2 * sizeof(void*)) / sizeof(T) > 4 ?
+        (int)((BYTES_BLOQUE - 2 * sizeof(void*)) / sizeof(T)) : 4;
+};
+
+/**
+ * @brief Rasgos comunes de los tipos enteros
+ * @tparam T Tipo entero
+ */
+template <typename T>
+struct RasgosEntero {
+    typedef long long Acumulador;  // La suma de enteros es exacta
+    
+    static constexpr bool EN_BLOQUES = true;
+    static constexpr size_t BYTES_BLOQUE = 256;
+    static constexpr int DATOS_POR_BLOQUE =
+        (int)((BYTES_BLOQUE - 2 * sizeof(void*)) / sizeof(T));
+};
+
+template <> struct RasgosLectura<int> : RasgosEntero<int> {};
+template <> struct RasgosLectura<short> : RasgosEntero<short> {};
+template <> struct RasgosLectura<long> : RasgosEntero<long> {};
+template <> struct RasgosLectura<long long> : RasgosEntero<long long> {};
+
+#endif // RASGOS_LECTURA_H
\ No newline at end of file
@@ -0,0 +1,282 @@
+#ifndef REGISTRO_TIPOS_H
+#define REGISTRO_TIPOS_H
+
+#include <cstdio>   // Para printf (C puro, sin STL)
+#include <cstring>  // Para memset
+#include <new>      // Para construir sensores en memoria ya reservada
+#include "SensorBase.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "SensorHumedad.h"
+#include "SensorVibracion.h"
+#include "SensorMulticanal.h"
+#include "SimuladorArduino.h"
+
+/**
+ * @brief Descripcion de un tipo de sensor en el registro
+ * 
+ * Lo arma describirTipo<S>() a partir de lo que declara la clase S:
+ *  - typedef Valor: tipo de cada lectura (de el salen los rasgos de
+ *    almacenamiento del historial, ver RasgosLectura.h)
+ *  - CODIGO y CANALES
+ *  - configDetector(): parametros del detector de anomalias
+ * 
+ * Con la tabla de apuntadores a funcion, la lista de gestion, el
+ * exportador y el menu trabajan con cualquier tipo sin dynamic_cast.
+ */
+struct TipoSensor {
+    static const int MAXIMO_CANALES = 8;
+    
+    char codigo;              // Letra del tipo ('T', 'P', ...)
+    const char* nombre;       // Para menus y reportes
+    const char* unidad;       // Unidad de las lecturas
+    int canales;              // Valores por lectura
+    bool entero;              // El historial guarda enteros
+    bool enBloques;           // El historial guarda los datos en bloques contiguos
+    size_t bytes;             // sizeof del sensor (para construirlo en una arena)
+    ConfigDetector detector;  // Parametros del detector de anomalias
+    
+    /** Crea un sensor con new */
+    SensorBase* (*crear)(const char* id);
+    /** Construye un sensor en memoria ya reservada de al menos bytes */
+    SensorBase* (*construirEn)(void* memoria, const char* id);
+    /** Genera una lectura simulada (canales valores) sin imprimir */
+    void (*simular)(unsigned& semilla, double* valores);
+};
+
+/**
+ * @brief Crea un sensor de tipo S
+ * @tparam S Clase del sensor
+ * @param id Identificador
+ * @return Sensor nuevo
+ */
+template <class S>
+SensorBase* crearSensorDe(const char* id) {
+    return new S(id);
+}
+
+/**
+ * @brief Construye un sensor de tipo S en memoria ya reservada
+ * @tparam S Clase del sensor
+ * @param memoria Espacio de al menos sizeof(S), alineado a 16
+ * @param id Identificador
+ * @return El sensor construido
+ */
+template <class S>
+SensorBase* construirSensorEn(void* memoria, const char* id) {
+    return ::new (memoria) S(id);
+}
+
+/**
+ * @brief Arma la descripcion de un tipo con lo que declara su clase
+ * @tparam S Clase del sensor
+ * @param nombre Nombre para menus
+ * @param unidad Unidad de las lecturas
+ * @param simular Generador de lecturas simuladas
+ * @return La descripcion lista para RegistroTipos::registrar
+ */
+template <class S>
+TipoSensor describirTipo(const char* nombre, const char* unidad,
+                         void (*simular)(unsigned&, double*)) {
+    typedef typename S::Valor Valor;
+    TipoSensor tipo;
+    tipo.codigo = S::CODIGO;
+    tipo.nombre = nombre;
+    tipo.unidad = unidad;
+    tipo.canales = S::CANALES;
+    tipo.entero = (Valor)0.5 == (Valor)0;  // Los enteros truncan el medio
+    tipo.enBloques = RasgosLectura<Valor>::EN_BLOQUES;
+    tipo.bytes = sizeof(S);
+    tipo.detector = S::configDetector();
+    tipo.crear = crearSensorDe<S>;
+    tipo.construirEn = construirSensorEn<S>;
+    tipo.simular = simular;
+    return tipo;
+}
+
+/** @brief Estacion de tres canales: temperatura, humedad y presion */
+typedef SensorMulticanal<3> SensorEstacion;
+
+/**
+ * @brief Lectura simulada de temperatura
+ * @param s Semilla
+ * @param v Salida (1 valor)
+ */
+inline void simularTemperatura(unsigned& s, double* v) {
+    v[0] = SimuladorArduino::generarTemperatura(s);
+}
+
+/**
+ * @brief Lectura simulada de presion
+ * @param s Semilla
+ * @param v Salida (1 valor)
+ */
+inline void simularPresion(unsigned& s, double* v) {
+    v[0] = SimuladorArduino::generarPresion(s);
+}
+
+/**
+ * @brief Lectura simulada de humedad
+ * @param s Semilla
+ * @param v Salida (1 valor)
+ */
+inline void simularHumedad(unsigned& s, double* v) {
+    v[0] = SimuladorArduino::generarHumedad(s);
+}
+
+/**
+ * @brief Muestra simulada de vibracion
+ * @param s Semilla
+ * @param v Salida (1 valor)
+ */
+inline void simularVibracion(unsigned& s, double* v) {
+    v[0] = SimuladorArduino::generarVibracion(s);
+}
+
+/**
+ * @brief Trama simulada de la estacion
+ * @param s Semilla
+ * @param v Salida (3 valores)
+ */
+inline void simularEstacion(unsigned& s, double* v) {
+    v[0] = SimuladorArduino::generarTemperatura(s);
+    v[1] = SimuladorArduino::generarHumedad(s);
+    v[2] = SimuladorArduino::generarPresion(s);
+}
+
+/**
+ * @brief Registro global de tipos de sensor
+ * 
+ * Los tipos incluidos se registran solos la primera vez que se consulta
+ * la tabla. Para agregar uno nuevo basta con escribir su clase y llamar,
+ * antes de crear sensores de ese tipo:
+ * 
+ *     RegistroTipos::registrar(describirTipo<MiSensor>("Mi tipo", "u", simularMio));
+ * 
+ * La busqueda por codigo es un arreglo de 256 entradas (O(1)). Registrar
+ * no usa candados: hay que hacerlo al arrancar, antes de lanzar hilos.
+ */
+class RegistroTipos {
+public:
+    static const int MAXIMO = 32;  // Tipos que caben en la tabla
+
+private:
+    /**
+     * @brief Tabla de tipos y su indice por codigo
+     */
+    struct Tabla {
+        TipoSensor tipos[MAXIMO];
+        int cantidad;
+        signed char porCodigo[256];  // Posicion en tipos, -1 si el codigo esta libre
+        
+        /**
+         * @brief Constructor que registra los tipos incluidos
+         */
+        Tabla() : cantidad(0) {
+            memset(porCodigo, -1, sizeof(porCodigo));
+            agregar(*this, describirTipo<SensorTemperatura>("Temperatura", "C", simularTemperatura));
+            agregar(*this, describirTipo<SensorPresion>("Presion", "Pa", simularPresion));
+            agregar(*this, describirTipo<SensorHumedad>("Humedad", "%", simularHumedad));
+            agregar(*this, describirTipo<SensorVibracion>("Vibracion", "cuentas", simularVibracion));
+            agregar(*this, describirTipo<SensorEstacion>("Estacion (temperatura, humedad, presion)",
+                                                         "C, %, Pa", simularEstacion));
+        }
+    };
+    
+    /**
+     * @brief La tabla (se crea y llena en la primera consulta)
+     * @return Referencia a la tabla
+     */
+    static Tabla& tabla() {
+        static Tabla t;
+        return t;
+    }
+    
+    /**
+     * @brief Agrega un tipo a una tabla
+     * @param t Tabla destino
+     * @param tipo Descripcion del tipo
+     * @return false si el codigo ya esta usado, es invalido o no hay lugar
+     */
+    static bool agregar(Tabla& t, const TipoSensor& tipo) {
+        unsigned char codigo = (unsigned char)tipo.codigo;
+        if (codigo == 0 || t.porCodigo[codigo] >= 0 || t.cantidad == MAXIMO ||
+            tipo.canales < 1 || tipo.canales > TipoSensor::MAXIMO_CANALES) {
+            return false;
+        }
+        t.tipos[t.cantidad] = tipo;
+        t.porCodigo[codigo] = (signed char)t.cantidad;
+        t.cantidad++;
+        return true;
+    }
+
+public:
+    /**
+     * @brief Registra un tipo nuevo
+     * @param tipo Descripcion (normalmente de describirTipo<S>)
+     * @return true si quedo registrado
+     */
+    static bool registrar(const TipoSensor& tipo) {
+        if (!agregar(tabla(), tipo)) {
+            printf("[Registro] Error: no pude registrar el tipo '%c' (codigo repetido o tabla llena)\n",
+                   tipo.codigo);
+            return false;
+        }
+        BITACORA("[Registro] Tipo '%c' (%s) registrado.\n", tipo.codigo, tipo.nombre);
+        return true;
+    }
+    
+    /**
+     * @brief Busca un tipo por su codigo
+     * @param codigo Letra del tipo
+     * @return La descripcion, NULL si no esta registrado
+     */
+    static const TipoSensor* buscar(char codigo) {
+        Tabla& t = tabla();
+        int posicion = t.porCodigo[(unsigned char)codigo];
+        return posicion < 0 ? NULL : &t.tipos[posicion];
+    }
+    
+    /**
+     * @brief Posicion de un tipo en la tabla
+     * @param codigo Letra del tipo
+     * @return Posicion (0 a cantidad()-1), -1 si no esta registrado
+     */
+    static int posicion(char codigo) {
+        return tabla().porCodigo[(unsigned char)codigo];
+    }
+    
+    /**
+     * @brief Cantidad de tipos registrados
+     * @return Numero de tipos
+     */
+    static int cantidad() {
+        return tabla().cantidad;
+    }
+    
+    /**
+     * @brief Tipo en una posicion de la tabla (en orden de registro)
+     * @param i Posicion (0 a cantidad()-1)
+     * @return La descripcion
+     */
+    static const TipoSensor& enPosicion(int i) {
+        return tabla().tipos[i];
+    }
+    
+    /**
+     * @brief Muestra la tabla de tipos
+     */
+    static void imprimir() {
+        printf("\n=== Tipos de Sensor Registrados ===\n");
+        for (int i = 0; i < cantidad(); i++) {
+            const TipoSensor& t = enPosicion(i);
+            printf("%c - %s [%s]: %d canal%s, %s, %s, %lu bytes por sensor\n",
+                   t.codigo, t.nombre, t.unidad, t.canales, t.canales == 1 ? "" : "es",
+                   t.entero ? "enteros" : "flotantes",
+                   t.enBloques ? "historial en bloques" : "historial por nodos",
+                   (unsigned long)t.bytes);
+        }
+    }
+};
+
+#endif // REGISTRO_TIPOS_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef RELOJ_H
+#define RELOJ_H
+
+#include <ctime>  // Para clock_gettime (C puro, sin STL)
+
+/**
+ * @brief Lee el reloj monotono del sistema
+ * 
+ * Lo uso para medir tiempos en los benchmarks; no depende de la hora
+ * del dia, asi que no brinca si alguien cambia el reloj.
+ * 
+ * @return Tiempo actual en nanosegundos
+ */
+inline long long relojNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Convierte una diferencia de nanosegundos a milisegundos
+ * @param ns Tiempo en nanosegundos
+ * @return Tiempo en milisegundos
+ */
+inline double nsAMs(long long ns) {
+    return ns / 1000000.0;
+}
+
+#endif // RELOJ_H
\ No newline at end of file
@@ -0,0 +1,536 @@
+#ifndef REPRODUCCION_DIFERENCIAL_H
+#define REPRODUCCION_DIFERENCIAL_H
+
+#include <cstdio>   // Para printf, snprintf (C puro, sin STL)
+#include <cstdlib>  // Para malloc, free
+#include <cstring>  // Para strcmp
+#include <cmath>    // Para fabs, HUGE_VAL
+#include "ListaSensor.h"
+#include "ListaGestion.h"
+#include "ListaGestionFragmentada.h"
+#include "RegistroTipos.h"
+
+/**
+ * @brief Operaciones que se graban en un flujo
+ */
+enum TipoPaso {
+    PASO_INSERTAR,         // Un valor al final de un historial
+    PASO_INSERTAR_LOTE,    // Varios valores seguidos (registrarLote en sensores)
+    PASO_BUSCAR,           // Buscar un valor en un historial o un ID en el registro
+    PASO_ELIMINAR_MINIMO,  // eliminarMasBajo
+    PASO_PROMEDIO,         // calcularPromedio
+    PASO_PROCESAR_TODOS,   // procesarTodos del registro
+    TOTAL_PASOS
+};
+
+/**
+ * @brief Nombre de un tipo de paso para los reportes
+ * @param tipo Tipo de paso
+ * @return Nombre corto
+ */
+inline const char* nombrePaso(int tipo) {
+    static const char* nombres[TOTAL_PASOS] = {
+        "insertar", "insertarLote", "buscar", "eliminarMasBajo", "promedio", "procesarTodos"
+    };
+    return tipo >= 0 && tipo < TOTAL_PASOS ? nombres[tipo] : "?";
+}
+
+/**
+ * @brief Una operacion grabada
+ */
+struct Paso {
+    unsigned char tipo;  // TipoPaso
+    int destino;         // Historial o sensor (en busquedas de ID puede ser uno que no existe)
+    int inicio;          // Primer valor en el arreglo de valores del flujo
+    int cantidad;        // Cuantos valores usa el paso
+};
+
+/**
+ * @brief Siguiente numero de un xorshift de 32 bits
+ * 
+ * No uso rand() para que el mismo flujo salga igual en cualquier
+ * plataforma y sin importar quien mas use rand() en el programa.
+ * 
+ * @param estado Estado del generador (distinto de 0)
+ * @return Numero pseudoaleatorio
+ */
+inline unsigned siguienteAleatorio(unsigned& estado) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+/**
+ * @brief Flujo de operaciones grabado a partir de una semilla
+ * 
+ * La misma semilla da siempre el mismo flujo, asi que una diferencia se
+ * reproduce con solo repetir la semilla. Los valores van en medios
+ * (-50.0 a 50.0 en pasos de 0.5) para que haya repetidos y empates en el
+ * minimo, y para que se representen exactos en float.
+ * 
+ * Hay dos mezclas: la de historiales (insertar, lotes, busquedas,
+ * eliminarMasBajo y promedio sobre varias listas) y la de registro
+ * (lotes de lecturas a sensores, busquedas de IDs que existen y que no,
+ * y procesarTodos de vez en cuando).
+ */
+class FlujoOperaciones {
+private:
+    Paso* pasos;        // Operaciones en orden
+    int cantidad;       // Cuantas operaciones
+    double* valores;    // Valores que insertan o buscan los pasos
+    int totalValores;   // Cuantos valores
+    int destinos;       // Historiales o sensores que existen
+    int desconocidos;   // IDs extra que nunca se registran (solo registro)
+    char* nombres;      // IDs de los sensores (solo registro)
+    unsigned semilla;   // Con la que se grabo
+    
+    static const int LOTE_MAXIMO = 16;
+    static const int LARGO_NOMBRE = 16;
+    
+    // No se copia: es duenio de sus arreglos
+    FlujoOperaciones(const FlujoOperaciones&);
+    FlujoOperaciones& operator=(const FlujoOperaciones&);
+    
+    /**
+     * @brief Agrega valores nuevos al arreglo de valores
+     * @param estado Generador
+     * @param n Cuantos
+     * @return Posicion del primero
+     */
+    int nuevosValores(unsigned& estado, int n) {
+        int inicio = totalValores;
+        for (int i = 0; i < n; i++) {
+            valores[totalValores++] = (int)(siguienteAleatorio(estado) % 201) * 0.5 - 50.0;
+        }
+        return inicio;
+    }
+
+public:
+    /**
+     * @brief Graba un flujo
+     * @param semillaInicial Semilla (0 se cambia por 1)
+     * @param operaciones Cuantas operaciones
+     * @param cuantosDestinos Cuantos historiales o sensores
+     * @param deRegistro true para la mezcla de registro, false para la de historiales
+     */
+    FlujoOperaciones(unsigned semillaInicial, int operaciones, int cuantosDestinos, bool deRegistro)
+        : cantidad(operaciones < 1 ? 1 : operaciones), totalValores(0),
+          destinos(cuantosDestinos < 1 ? 1 : cuantosDestinos),
+          desconocidos(deRegistro ? destinos / 8 + 1 : 0), nombres(NULL),
+          semilla(semillaInicial == 0 ? 1 : semillaInicial) {
+        pasos = (Paso*)malloc(sizeof(Paso) * cantidad);
+        valores = (double*)malloc(sizeof(double) * (size_t)cantidad * LOTE_MAXIMO);
+        
+        unsigned estado = semilla;
+        for (int i = 0; i < cantidad; i++) {
+            Paso& p = pasos[i];
+            unsigned dado = siguienteAleatorio(estado) % 1000;
+            p.destino = (int)(siguienteAleatorio(estado) % (unsigned)destinos);
+            p.inicio = totalValores;
+            p.cantidad = 0;
+            if (deRegistro) {
+                if (dado < 5) {
+                    p.tipo = PASO_PROCESAR_TODOS;
+                } else if (dado < 350) {
+                    p.tipo = PASO_BUSCAR;
+                    // Uno de cada cuatro busca un ID que no esta registrado
+                    if (siguienteAleatorio(estado) % 4 == 0) {
+                        p.destino = destinos + (int)(siguienteAleatorio(estado) % (unsigned)desconocidos);
+                    }
+                } else {
+                    p.tipo = PASO_INSERTAR_LOTE;
+                    p.cantidad = 1 + (int)(siguienteAleatorio(estado) % LOTE_MAXIMO);
+                    p.inicio = nuevosValores(estado, p.cantidad);
+                }
+            } else if (dado < 350) {
+                p.tipo = PASO_INSERTAR;
+                p.cantidad = 1;
+                p.inicio = nuevosValores(estado, 1);
+            } else if (dado < 500) {
+                p.tipo = PASO_INSERTAR_LOTE;
+                p.cantidad = 1 + (int)(siguienteAleatorio(estado) % LOTE_MAXIMO);
+                p.inicio = nuevosValores(estado, p.cantidad);
+            } else if (dado < 700) {
+                p.tipo = PASO_BUSCAR;
+                p.cantidad = 1;
+                // La mitad busca un valor que ya salio (puede que ya lo hayan eliminado)
+                if (totalValores > 0 && siguienteAleatorio(estado) % 2 == 0) {
+                    p.inicio = (int)(siguienteAleatorio(estado) % (unsigned)totalValores);
+                } else {
+                    p.inicio = nuevosValores(estado, 1);
+                }
+            } else if (dado < 850) {
+                p.tipo = PASO_ELIMINAR_MINIMO;
+            } else {
+                p.tipo = PASO_PROMEDIO;
+            }
+        }
+        
+        if (deRegistro) {
+            nombres = (char*)malloc((size_t)(destinos + desconocidos) * LARGO_NOMBRE);
+            for (int i = 0; i < destinos + desconocidos; i++) {
+                char codigo = i < destinos ? RegistroTipos::enPosicion(i % RegistroTipos::cantidad()).codigo : 'X';
+                snprintf(nombres + (size_t)i * LARGO_NOMBRE, LARGO_NOMBRE, "%c-%06d", codigo, i);
+            }
+        }
+    }
+    
+    /**
+     * @brief Destructor que libera los arreglos
+     */
+    ~FlujoOperaciones() {
+        free(pasos);
+        free(valores);
+        free(nombres);
+    }
+    
+    /**
+     * @brief Cantidad de operaciones
+     * @return Pasos del flujo
+     */
+    int obtenerCantidad() const {
+        return cantidad;
+    }
+    
+    /**
+     * @brief Historiales o sensores a los que van las operaciones
+     * @return Cantidad de destinos
+     */
+    int obtenerDestinos() const {
+        return destinos;
+    }
+    
+    /**
+     * @brief Semilla con la que se grabo (para repetir el flujo)
+     * @return Semilla
+     */
+    unsigned obtenerSemilla() const {
+        return semilla;
+    }
+    
+    /**
+     * @brief Una operacion del flujo
+     * @param i Posicion (0 a obtenerCantidad()-1)
+     * @return El paso
+     */
+    const Paso& paso(int i) const {
+        return pasos[i];
+    }
+    
+    /**
+     * @brief Valores que usa un paso
+     * @param p Paso del flujo
+     * @return Apuntador a sus p.cantidad valores
+     */
+    const double* valoresDe(const Paso& p) const {
+        return valores + p.inicio;
+    }
+    
+    /**
+     * @brief ID del sensor de un destino (solo en flujos de registro)
+     * @param destino Destino del paso
+     * @return ID terminado en '\0'
+     */
+    const char* nombreDe(int destino) const {
+        return nombres + (size_t)destino * LARGO_NOMBRE;
+    }
+    
+    /**
+     * @brief Cuenta los pasos de un tipo
+     * @param tipo Tipo de paso
+     * @return Cuantos hay en el flujo
+     */
+    int contar(int tipo) const {
+        int total = 0;
+        for (int i = 0; i < cantidad; i++) total += pasos[i].tipo == tipo;
+        return total;
+    }
+};
+
+/**
+ * @brief Reproduce un flujo de historiales sobre un arreglo de listas
+ * 
+ * Cada paso deja un resultado que se puede comparar entre
+ * implementaciones: el tamanio despues de insertar, 1/0 al buscar, el
+ * valor eliminado (HUGE_VAL si estaba vacia) y el promedio.
+ * 
+ * @tparam T Tipo de las lecturas
+ * @tparam EnBloques Implementacion de ListaSensor
+ * @param flujo Flujo grabado
+ * @param listas Una lista por destino
+ * @param resultados Un resultado por paso
+ */
+template <typename T, bool EnBloques>
+void reproducirListas(const FlujoOperaciones& flujo, ListaSensor<T, EnBloques>* listas, double* resultados) {
+    T lote[16];
+    for (int i = 0; i < flujo.obtenerCantidad(); i++) {
+        const Paso& p = flujo.paso(i);
+        ListaSensor<T, EnBloques>& lista = listas[p.destino];
+        const double* v = flujo.valoresDe(p);
+        switch (p.tipo) {
+            case PASO_INSERTAR:
+                lista.insertarAlFinal((T)v[0]);
+                resultados[i] = lista.obtenerTamanio();
+                break;
+            case PASO_INSERTAR_LOTE:
+                for (int k = 0; k < p.cantidad; k++) lote[k] = (T)v[k];
+                lista.insertarLote(lote, p.cantidad);
+                resultados[i] = lista.obtenerTamanio();
+                break;
+            case PASO_BUSCAR:
+                resultados[i] = lista.buscar((T)v[0]) ? 1.0 : 0.0;
+                break;
+            case PASO_ELIMINAR_MINIMO: {
+                T minimo;
+                resultados[i] = lista.extraerMinimo(minimo) ? (double)minimo : HUGE_VAL;
+                break;
+            }
+            case PASO_PROMEDIO:
+                resultados[i] = lista.calcularPromedio();
+                break;
+            default:
+                resultados[i] = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Registro de referencia: arreglo de sensores y busqueda lineal
+ * 
+ * Es lo mas simple que cumple la interfaz que usa la reproduccion:
+ * buscar compara el ID contra todos y procesarTodos revisa el indicador
+ * de sucio de cada sensor. Sirve para comparar contra el indice hash y la
+ * cola de sucios de ListaGestion y contra el registro fragmentado.
+ */
+class RegistroReferencia {
+private:
+    SensorBase** sensores;  // En orden de registro
+    int cantidad;
+    int capacidad;
+    
+    // No se copia: es duenio de sus sensores
+    RegistroReferencia(const RegistroReferencia&);
+    RegistroReferencia& operator=(const RegistroReferencia&);
+
+public:
+    /**
+     * @brief Constructor que crea el registro vacio
+     * @param capacidadInicial Sensores que caben sin crecer
+     */
+    explicit RegistroReferencia(int capacidadInicial)
+        : cantidad(0), capacidad(capacidadInicial < 1 ? 1 : capacidadInicial) {
+        sensores = (SensorBase**)malloc(sizeof(SensorBase*) * capacidad);
+    }
+    
+    /**
+     * @brief Destructor que libera los sensores
+     */
+    ~RegistroReferencia() {
+        for (int i = 0; i < cantidad; i++) delete sensores[i];
+        free(sensores);
+    }
+    
+    /**
+     * @brief Registra un sensor (el registro se queda con el)
+     * @param sensor Sensor nuevo
+     */
+    void agregarSensor(SensorBase* sensor) {
+        if (cantidad == capacidad) {
+            capacidad *= 2;
+            sensores = (SensorBase**)realloc(sensores, sizeof(SensorBase*) * capacidad);
+        }
+        sensores[cantidad++] = sensor;
+    }
+    
+    /**
+     * @brief Busca un sensor comparando contra todos
+     * @param id Identificador
+     * @return El sensor, NULL si no esta
+     */
+    SensorBase* buscarSensor(const char* id) {
+        for (int i = 0; i < cantidad; i++) {
+            if (strcmp(sensores[i]->obtenerNombre(), id) == 0) return sensores[i];
+        }
+        return NULL;
+    }
+    
+    /**
+     * @brief Procesa los sensores sucios revisandolos todos
+     * @return Cantidad de sensores procesados
+     */
+    int procesarTodos() {
+        int procesados = 0;
+        for (int i = 0; i < cantidad; i++) {
+            if (!sensores[i]->estaSucio()) continue;
+            sensores[i]->limpiarSucio();
+            sensores[i]->procesarLectura();
+            procesados++;
+        }
+        return procesados;
+    }
+};
+
+/**
+ * @brief Registra un sensor por destino del flujo (el tipo rota por el registro de tipos)
+ * @tparam Registro RegistroReferencia, ListaGestion o ListaGestionFragmentada
+ * @param flujo Flujo de registro
+ * @param registro Registro vacio
+ */
+template <class Registro>
+void poblarRegistro(const FlujoOperaciones& flujo, Registro& registro) {
+    for (int i = 0; i < flujo.obtenerDestinos(); i++) {
+        const TipoSensor& tipo = RegistroTipos::enPosicion(i % RegistroTipos::cantidad());
+        registro.agregarSensor(tipo.crear(flujo.nombreDe(i)));
+    }
+}
+
+/**
+ * @brief Reproduce un flujo de registro
+ * 
+ * Resultados por paso: lecturas del sensor despues del lote, 1/0 al
+ * buscar y cuantos sensores proceso procesarTodos.
+ * 
+ * @tparam Registro RegistroReferencia, ListaGestion o ListaGestionFragmentada
+ * @param flujo Flujo grabado
+ * @param registro Registro ya poblado con poblarRegistro
+ * @param resultados Un resultado por paso
+ */
+template <class Registro>
+void reproducirRegistro(const FlujoOperaciones& flujo, Registro& registro, double* resultados) {
+    for (int i = 0; i < flujo.obtenerCantidad(); i++) {
+        const Paso& p = flujo.paso(i);
+        if (p.tipo == PASO_PROCESAR_TODOS) {
+            resultados[i] = registro.procesarTodos();
+            continue;
+        }
+        SensorBase* sensor = registro.buscarSensor(flujo.nombreDe(p.destino));
+        if (p.tipo == PASO_BUSCAR) {
+            resultados[i] = sensor != NULL ? 1.0 : 0.0;
+        } else {
+            sensor->registrarLote(flujo.valoresDe(p), p.cantidad);
+            resultados[i] = sensor->obtenerCantidadLecturas();
+        }
+    }
+}
+
+/**
+ * @brief Compara los resultados de dos reproducciones del mismo flujo
+ * 
+ * Los promedios se comparan con tolerancia relativa (el orden de las
+ * sumas puede cambiar entre implementaciones); todo lo demas debe ser
+ * identico. Imprime las primeras diferencias con su paso y destino.
+ * 
+ * @param nombre Implementacion comparada
+ * @param flujo Flujo reproducido
+ * @param referencia Resultados de la referencia
+ * @param otros Resultados de la implementacion
+ * @param tolerancia Error relativo permitido en promedios
+ * @return Cantidad de pasos distintos
+ */
+inline int contarDiferencias(const char* nombre, const FlujoOperaciones& flujo,
+                             const double* referencia, const double* otros, double tolerancia) {
+    int diferencias = 0;
+    for (int i = 0; i < flujo.obtenerCantidad(); i++) {
+        const Paso& p = flujo.paso(i);
+        double a = referencia[i];
+        double b = otros[i];
+        bool iguales = a == b;
+        if (!iguales && p.tipo == PASO_PROMEDIO) {
+            double escala = fabs(a) > 1.0 ? fabs(a) : 1.0;
+            iguales = fabs(a - b) <= tolerancia * escala;
+        }
+        if (iguales) continue;
+        if (diferencias < 3) {
+            printf("  [%s] paso %d (%s, destino %d): referencia %.9g, obtuve %.9g\n",
+                   nombre, i, nombrePaso(p.tipo), p.destino, a, b);
+        }
+        diferencias++;
+    }
+    return diferencias;
+}
+
+/**
+ * @brief Acceso a los historiales de un arreglo de listas para compararlos
+ * @tparam T Tipo de las lecturas
+ * @tparam EnBloques Implementacion de ListaSensor
+ */
+template <typename T, bool EnBloques>
+struct HistorialesDeListas {
+    ListaSensor<T, EnBloques>* listas;
+    
+    /**
+     * @brief Copia por partes el historial de un destino
+     * @param i Destino
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantos valores copie
+     */
+    int copiar(int i, double* destino, int maximo, CursorLecturas& cursor) const {
+        return listas[i].copiarComo(destino, maximo, cursor);
+    }
+};
+
+/**
+ * @brief Acceso a los historiales de los sensores de un registro
+ * @tparam Registro RegistroReferencia, ListaGestion o ListaGestionFragmentada
+ */
+template <class Registro>
+struct HistorialesDeRegistro {
+    Registro* registro;
+    const FlujoOperaciones* flujo;
+    
+    /**
+     * @brief Copia por partes el historial del sensor de un destino
+     * @param i Destino
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantos valores copie
+     */
+    int copiar(int i, double* destino, int maximo, CursorLecturas& cursor) const {
+        return registro->buscarSensor(flujo->nombreDe(i))->copiarLecturas(destino, maximo, cursor);
+    }
+};
+
+/**
+ * @brief Compara el contenido final de dos juegos de historiales
+ * @tparam A HistorialesDeListas o HistorialesDeRegistro de la referencia
+ * @tparam B Lo mismo para la implementacion comparada
+ * @param nombre Implementacion comparada
+ * @param cuantos Cuantos historiales
+ * @param referencia Historiales de la referencia
+ * @param otros Historiales de la implementacion
+ * @return Cuantos historiales son distintos
+ */
+template <class A, class B>
+int compararContenidos(const char* nombre, int cuantos, const A& referencia, const B& otros) {
+    const int TRAMO = 512;
+    double a[TRAMO];
+    double b[TRAMO];
+    int distintos = 0;
+    for (int i = 0; i < cuantos; i++) {
+        CursorLecturas ca;
+        CursorLecturas cb;
+        long long posicion = 0;
+        bool iguales = true;
+        while (iguales) {
+            int na = referencia.copiar(i, a, TRAMO, ca);
+            int nb = otros.copiar(i, b, TRAMO, cb);
+            int k = 0;
+            while (k < na && k < nb && a[k] == b[k]) k++;
+            posicion += k;
+            if (k < na || k < nb) iguales = false;
+            if (!iguales || na == 0) break;
+        }
+        if (iguales) continue;
+        if (distintos < 3) {
+            printf("  [%s] historial %d distinto desde la lectura %lld\n", nombre, i, posicion);
+        }
+        distintos++;
+    }
+    return distintos;
+}
+
+#endif // REPRODUCCION_DIFERENCIAL_H
\ No newline at end of file
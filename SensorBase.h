@@ -3,8 +3,48 @@
 #ifndef SENSOR_BASE_H
 #define SENSOR_BASE_H
 
-#include <cstring>  // Para strncpy (C puro)
+#include <cstring>  // Para strncpy, memset (C puro)
 #include <cstdio>   // Para printf (C puro)
+#include "Bitacora.h"
+#include "ContadorMemoria.h"
+#include "ListaSensor.h"  // Para CursorLecturas y ArenaBloques
+#include "DetectorAnomalias.h"
+
+class SensorBase;
+
+/**
+ * @brief Cola de sensores "sucios" (con lecturas nuevas sin procesar)
+ * 
+ * Es una lista enlazada intrusiva: el enlace vive dentro del propio
+ * sensor, asi que encolar o sacar un sensor no pide memoria. La duenia
+ * de la cola es la lista de gestion.
+ */
+struct ColaSucios {
+    SensorBase* cabeza;  // Primer sensor pendiente
+    SensorBase* cola;    // Ultimo sensor pendiente (para encolar en O(1))
+    int cantidad;        // Cuantos sensores estan pendientes (ver contar)
+    
+    /**
+     * @brief Constructor que crea la cola vacia
+     */
+    ColaSucios() : cabeza(NULL), cola(NULL), cantidad(0) {}
+    
+    /**
+     * @brief Ajusta cantidad con un guardado atomico relajado
+     * 
+     * Solo escribe el duenio de la cola, pero asi otro hilo puede ver si
+     * hay pendientes sin tomar su candado (ListaGestionFragmentada).
+     * 
+     * @param cambio +1 o -1
+     */
+    void contar(int cambio) {
+        __atomic_store_n(&cantidad, cantidad + cambio, __ATOMIC_RELAXED);
+    }
+    
+    void encolar(SensorBase* sensor);
+    SensorBase* extraer();
+    int quitarSi(bool (*quitar)(const SensorBase*, void*), void* contexto);
+};
 
 /**
  * @brief Clase abstracta que define la interfaz comun para todos los sensores
@@ -13,15 +53,25 @@
  * para crear sensores especificos
  */
 class SensorBase {
+    friend struct ColaSucios;  // La cola maneja el enlace siguienteSucio
+
 protected:
     char nombre[50];  // Identificador unico del sensor (ej: "T-001")
     
+private:
+    bool sucio;                  // true si hay lecturas nuevas desde el ultimo procesamiento
+    SensorBase* siguienteSucio;  // Enlace dentro de la cola de sucios
+    ColaSucios* colaSucios;      // Cola de la lista de gestion a la que pertenezco
+    DetectorAnomalias* detector; // NULL si no reviso anomalias al registrar
+    ArenaBloques* arenaDetector; // De donde sale el detector, NULL para el contador global
+    
 public:
     /**
      * @brief Constructor que inicializa el nombre del sensor
      * @param id Cadena con el identificador del sensor
      */
-    SensorBase(const char* id) {
+    SensorBase(const char* id) : sucio(false), siguienteSucio(NULL), colaSucios(NULL), detector(NULL),
+                                 arenaDetector(NULL) {
         // Copio el nombre de forma segura para evitar desbordamientos
         strncpy(nombre, id, 49);
         nombre[49] = '\0';  // Me aseguro de que termine en null
@@ -34,7 +84,8 @@ public:
      * necesito que se llame al destructor correcto de esa clase
      */
     virtual ~SensorBase() {
-        printf("[Destructor Base] Liberando sensor: %s\n", nombre);  // Sin STL
+        DetectorAnomalias::destruir(detector);
+        BITACORA("[Destructor Base] Liberando sensor: %s\n", nombre);  // Sin STL
     }
     
     /**
@@ -49,6 +100,100 @@ public:
      */
     virtual void imprimirInfo() const = 0;
     
+    /**
+     * @brief Metodo virtual puro para registrar varias lecturas de un jalon
+     * 
+     * Las lecturas llegan como double para que el pipeline de ingesta no
+     * tenga que saber el tipo real del sensor; cada clase derivada las
+     * convierte a su tipo y las agrega a su historial en un solo paso.
+     * 
+     * @param valores Arreglo de lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas trae el arreglo
+     */
+    virtual void registrarLote(const double* valores, int cantidad) = 0;
+    
+    /**
+     * @brief Agrega lecturas ya aceptadas sin pasarlas por el detector
+     * 
+     * Para restaurar un historial guardado (importacion): esas lecturas ya
+     * pasaron el filtro cuando llegaron y el detector no debe volver a
+     * ponerlas en cuarentena ni contarlas. Sus contadores no cambian.
+     * 
+     * @param valores Arreglo de lecturas en orden
+     * @param cantidad Cuantas lecturas trae el arreglo
+     */
+    void restaurarLote(const double* valores, int cantidad) {
+        DetectorAnomalias* activo = detector;
+        detector = NULL;
+        registrarLote(valores, cantidad);
+        detector = activo;
+    }
+    
+    /**
+     * @brief Metodo virtual puro que dice cuantas lecturas guarda el sensor
+     * @return Tamanio del historial
+     */
+    virtual int obtenerCantidadLecturas() const = 0;
+    
+    /**
+     * @brief Metodo virtual puro que dice cuanta memoria es del sensor
+     * @return Bytes del objeto mas los de su historial
+     */
+    virtual size_t obtenerBytesPropios() const = 0;
+    
+    /**
+     * @brief Metodo virtual puro que identifica el tipo de sensor
+     * @return Codigo de una letra registrado en RegistroTipos ('T', 'P', ...)
+     */
+    virtual char obtenerTipo() const = 0;
+    
+    /**
+     * @brief Metodo virtual para los parametros del detector de este tipo
+     * @return Los que declara la clase derivada; aqui, los genericos
+     */
+    virtual ConfigDetector configDetectorTipo() const {
+        return ConfigDetector();
+    }
+    
+    /**
+     * @brief Metodo virtual puro para copiar el historial por partes
+     * @param destino Arreglo donde copio las lecturas (como double)
+     * @param maximo Espacio disponible en destino
+     * @param cursor Donde me quede la vez anterior (se actualiza)
+     * @return Cuantas lecturas copie; 0 cuando ya no hay mas
+     */
+    virtual int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const = 0;
+    
+    /**
+     * @brief Indica de donde debe pedir el historial sus bloques
+     * 
+     * La lista de gestion lo llama al registrar el sensor. Por defecto no
+     * hace nada (historiales que no usan bloques).
+     * 
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    virtual void usarArenaHistorial(ArenaBloques* arena) {
+        (void)arena;
+    }
+    
+    /**
+     * @brief Pido la memoria del sensor a traves del contador global
+     * @param bytes Tamanio que pide el compilador
+     * @return Memoria para el sensor
+     */
+    static void* operator new(size_t bytes) {
+        return ContadorMemoria::pedir(bytes);
+    }
+    
+    /**
+     * @brief Devuelvo la memoria del sensor al contador global
+     * @param p Memoria del sensor
+     * @param bytes Tamanio con el que se pidio
+     */
+    static void operator delete(void* p, size_t bytes) {
+        ContadorMemoria::devolver(p, bytes);
+    }
+    
     /**
      * @brief Obtiene el nombre del sensor
      * @return Puntero al nombre
@@ -56,6 +201,225 @@ public:
     const char* obtenerNombre() const {
         return nombre;  // Regreso el identificador
     }
+    
+    /**
+     * @brief Conecta el sensor a la cola de sucios de una lista de gestion
+     * 
+     * Si el sensor ya tenia lecturas pendientes lo encolo de una vez para
+     * que el siguiente procesamiento no se las salte.
+     * 
+     * @param cola Cola de la lista de gestion
+     */
+    void conectarColaSucios(ColaSucios* cola) {
+        colaSucios = cola;
+        if (sucio && colaSucios != NULL) {
+            colaSucios->encolar(this);
+        }
+    }
+    
+    /**
+     * @brief Indica si el sensor tiene lecturas sin procesar
+     * @return true si esta sucio
+     */
+    bool estaSucio() const {
+        return sucio;
+    }
+    
+    /**
+     * @brief Marca el sensor como procesado
+     */
+    void limpiarSucio() {
+        sucio = false;
+    }
+    
+    /**
+     * @brief Empieza a revisar anomalias antes de guardar cada lectura
+     * @param config Parametros del detector (reemplaza al anterior)
+     */
+    void activarDeteccion(const ConfigDetector& config) {
+        DetectorAnomalias::destruir(detector);
+        detector = DetectorAnomalias::crear(config, arenaDetector);
+    }
+    
+    /**
+     * @brief Empieza a revisar anomalias con los valores de su tipo
+     */
+    void activarDeteccion() {
+        activarDeteccion(configDetectorTipo());
+    }
+    
+    /**
+     * @brief Deja de revisar anomalias (se pierden los contadores)
+     */
+    void desactivarDeteccion() {
+        DetectorAnomalias::destruir(detector);
+        detector = NULL;
+    }
+    
+    /**
+     * @brief Indica de donde sale el detector (el actual se muda ahi)
+     * 
+     * La lista de gestion lo llama al registrar el sensor, con la misma
+     * arena de los historiales: asi un sensor construido en una arena no
+     * tiene nada fuera de arenas del registro.
+     * 
+     * @param arena Arena de bloques, NULL para pedirlo al contador global
+     */
+    void usarArenaDetector(ArenaBloques* arena) {
+        arenaDetector = arena;
+        detector = DetectorAnomalias::mudar(detector, arena);
+    }
+    
+    /**
+     * @brief Detector de anomalias del sensor
+     * @return El detector, NULL si no esta activo
+     */
+    const DetectorAnomalias* obtenerDetector() const {
+        return detector;
+    }
+
+protected:
+    /**
+     * @brief Pasa un tramo de lecturas por el detector (si hay)
+     * 
+     * Sin detector no copia nada: tramo sigue apuntando a las lecturas
+     * originales. Con detector, tramo pasa a apuntar a espacio, donde
+     * quedan solo las lecturas que deben ir al historial.
+     * 
+     * @param tramo Lecturas a revisar (puede cambiar a espacio)
+     * @param cantidad Cuantas lecturas
+     * @param espacio Arreglo de al menos cantidad lugares
+     * @return Cuantas lecturas deben guardarse
+     */
+    int filtrarAnomalias(const double*& tramo, int cantidad, double* espacio) {
+        if (detector == NULL) return cantidad;
+        int aceptadas = detector->filtrar(tramo, cantidad, espacio);
+        tramo = espacio;
+        return aceptadas;
+    }
+    
+    /**
+     * @brief Revisa una sola lectura
+     * @param valor Lectura nueva
+     * @return true si debe guardarse en el historial
+     */
+    bool admitirLectura(double valor) {
+        if (detector == NULL) return true;
+        double aceptada;
+        return detector->filtrar(&valor, 1, &aceptada) == 1;
+    }
+    
+    /**
+     * @brief Marca que lecturas de un tramo no deben guardarse
+     * 
+     * Para sensores que no guardan los valores sueltos (los de varios
+     * canales descartan la trama entera): el detector revisa el tramo y
+     * aqui solo queda la decision por lectura.
+     * 
+     * @param tramo Lecturas a revisar
+     * @param cantidad Cuantas lecturas
+     * @param espacio Arreglo de al menos cantidad lugares (se pisa)
+     * @param descartar Salida: 1 si la lectura se queda fuera
+     * @return Cuantas lecturas quedaron fuera
+     */
+    int marcarDescartes(const double* tramo, int cantidad, double* espacio, unsigned char* descartar) {
+        memset(descartar, 0, (size_t)cantidad);
+        if (detector == NULL) return 0;
+        detector->filtrar(tramo, cantidad, espacio, descartar);
+        // Sin cuarentena solo se marcan: se guardan todas menos las invalidas
+        int quitar = detector->obtenerConfig().cuarentena ? ~0 : ANOMALIA_INVALIDA;
+        int fuera = 0;
+        for (int i = 0; i < cantidad; i++) {
+            descartar[i] = (descartar[i] & quitar) != 0;
+            fuera += descartar[i];
+        }
+        return fuera;
+    }
+    
+    /**
+     * @brief Memoria del detector (0 si no hay)
+     * @return Bytes
+     */
+    size_t bytesDetector() const {
+        return detector != NULL ? detector->bytesUsados() : 0;
+    }
+    
+    /**
+     * @brief Marca el sensor como sucio y lo encola una sola vez
+     * 
+     * Las clases derivadas lo llaman cada vez que registran una lectura
+     */
+    void marcarSucio() {
+        if (sucio) return;  // Ya esta en la cola, no lo repito
+        sucio = true;
+        if (colaSucios != NULL) {
+            colaSucios->encolar(this);
+        }
+    }
 };
 
+/**
+ * @brief Agrega un sensor al final de la cola
+ * @param sensor Sensor que acaba de ensuciarse
+ */
+inline void ColaSucios::encolar(SensorBase* sensor) {
+    sensor->siguienteSucio = NULL;
+    if (cola == NULL) {
+        cabeza = sensor;
+    } else {
+        cola->siguienteSucio = sensor;
+    }
+    cola = sensor;
+    contar(1);
+}
+
+/**
+ * @brief Saca el primer sensor de la cola
+ * @return El sensor, o NULL si la cola esta vacia
+ */
+inline SensorBase* ColaSucios::extraer() {
+    if (cabeza == NULL) return NULL;
+    SensorBase* sensor = cabeza;
+    cabeza = sensor->siguienteSucio;
+    if (cabeza == NULL) cola = NULL;
+    sensor->siguienteSucio = NULL;
+    contar(-1);
+    return sensor;
+}
+
+/**
+ * @brief Saca de la cola los sensores que cumplan una condicion
+ * 
+ * Se usa antes de borrar sensores: en una sola pasada conservo el orden
+ * de los que se quedan. Los que salen quedan limpios.
+ * 
+ * @param quitar Funcion que dice si un sensor debe salir
+ * @param contexto Dato extra que se pasa tal cual a la funcion
+ * @return Cuantos sensores saque
+ */
+inline int ColaSucios::quitarSi(bool (*quitar)(const SensorBase*, void*), void* contexto) {
+    SensorBase* actual = cabeza;
+    SensorBase* anterior = NULL;
+    int quitados = 0;
+    while (actual != NULL) {
+        SensorBase* siguiente = actual->siguienteSucio;
+        if (quitar(actual, contexto)) {
+            if (anterior == NULL) {
+                cabeza = siguiente;
+            } else {
+                anterior->siguienteSucio = siguiente;
+            }
+            if (actual == cola) cola = anterior;
+            actual->siguienteSucio = NULL;
+            actual->sucio = false;
+            contar(-1);
+            quitados++;
+        } else {
+            anterior = actual;
+        }
+        actual = siguiente;
+    }
+    return quitados;
+}
+
 #endif // SENSOR_BASE_H
\ No newline at end of file
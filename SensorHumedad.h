@@ -0,0 +1,194 @@
+#ifndef SENSOR_HUMEDAD_H
+#define SENSOR_HUMEDAD_H
+
+#include "SensorBase.h"
+#include "ListaSensor.h"
+#include <cstdio>  // Para printf (C puro, sin STL)
+#include "Bitacora.h"
+
+/**
+ * @brief Clase concreta para sensores de humedad relativa
+ * 
+ * Hereda de SensorBase e implementa los metodos virtuales puros. Las
+ * lecturas son porcentajes (0 a 100) guardados como float.
+ */
+class SensorHumedad : public SensorBase {
+public:
+    typedef float Valor;             // Tipo de cada lectura en el historial
+    static const char CODIGO = 'H';  // Codigo de tipo (ver RegistroTipos.h)
+    static const int CANALES = 1;    // Valores por lectura
+    
+    /** Humedad a partir de la cual aviso riesgo de condensacion */
+    static constexpr double UMBRAL_CONDENSACION = 90.0;
+    
+    /**
+     * @brief Parametros del detector de anomalias para este tipo
+     * @return Configuracion pensada para humedad relativa
+     */
+    static ConfigDetector configDetector() {
+        ConfigDetector config;
+        config.cambioMaximo = 10.0;     // Puntos de % entre dos lecturas seguidas
+        config.desviacionMinima = 0.5;  // Resolucion del sensor
+        return config;
+    }
+
+private:
+    ListaSensor<Valor> historial;  // Lista que guarda todas las lecturas de humedad
+
+public:
+    /**
+     * @brief Constructor que crea un sensor de humedad
+     * @param id Identificador unico del sensor
+     */
+    SensorHumedad(const char* id) : SensorBase(id) {
+        BITACORA("[Sensor Humedad] Creado: %s\n", nombre);  // Sin STL
+    }
+    
+    /**
+     * @brief Destructor que limpia la memoria del historial
+     */
+    ~SensorHumedad() {
+        BITACORA("[Destructor Sensor] %s - Liberando historial de humedades...\n", nombre);
+        // El destructor de ListaSensor se encarga de liberar los bloques
+    }
+    
+    /**
+     * @brief Agrega una nueva lectura de humedad al historial
+     * @param valor La humedad leida (en %)
+     */
+    void registrarLectura(float valor) {
+        // Si el detector la toma como anomala no llega al historial
+        if (!admitirLectura(valor)) {
+            BITACORA("[%s] Humedad en cuarentena: %.1f %%\n", nombre, valor);
+            return;
+        }
+        
+        historial.insertarAlFinal(valor);
+        marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Humedad registrada: %.1f %%\n", nombre, valor);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega un lote de lecturas al historial
+     * 
+     * Convierte en bloques chicos sobre la pila para no pedir memoria
+     * extra, y engancha cada bloque con una sola insercion.
+     * Si hay detector de anomalias, cada bloque pasa antes por el.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas son
+     */
+    void registrarLote(const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        
+        float bloque[256];
+        double filtrados[256];
+        int hechos = 0;
+        int guardadas = 0;
+        while (hechos < cantidad) {
+            int n = cantidad - hechos;
+            if (n > 256) n = 256;
+            const double* tramo = valores;
+            int aceptadas = filtrarAnomalias(tramo, n, filtrados);
+            for (int i = 0; i < aceptadas; i++) {
+                bloque[i] = (float)tramo[i];
+            }
+            historial.insertarLote(bloque, aceptadas);
+            guardadas += aceptadas;
+            valores += n;
+            hechos += n;
+        }
+        if (guardadas > 0) marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Lote de %d humedades registrado (%d guardadas)\n", nombre, cantidad, guardadas);  // Sin STL
+    }
+    
+    /**
+     * @brief Procesamiento especifico para humedad
+     * 
+     * Calcula el promedio de todas las lecturas y avisa si pasa del
+     * umbral de condensacion
+     */
+    void procesarLectura() {
+        BITACORA("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
+        
+        if (historial.estaVacia()) {
+            BITACORA("[%s] No hay lecturas para procesar.\n", nombre);
+            return;
+        }
+        
+        double promedio = historial.calcularPromedio();
+        BITACORA("[Sensor Humedad] Promedio de humedad: %.1f %% (sobre %d lecturas)\n",
+                 promedio, historial.obtenerTamanio());
+        if (promedio >= UMBRAL_CONDENSACION) {
+            BITACORA("[Sensor Humedad] Aviso: riesgo de condensacion en %s\n", nombre);
+        }
+    }
+    
+    /**
+     * @brief Cantidad de lecturas en el historial
+     * @return Tamanio del historial
+     */
+    int obtenerCantidadLecturas() const {
+        return historial.obtenerTamanio();
+    }
+    
+    /**
+     * @brief Memoria del sensor y de su historial
+     * @return Bytes propios
+     */
+    size_t obtenerBytesPropios() const {
+        return sizeof(*this) + historial.bytesUsados() + bytesDetector();
+    }
+    
+    /**
+     * @brief Pasa el historial a la arena de bloques de la lista de gestion
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArenaHistorial(ArenaBloques* arena) {
+        historial.usarArena(arena);
+    }
+    
+    /**
+     * @brief Codigo de tipo para exportar e importar
+     * @return 'H' (humedad)
+     */
+    char obtenerTipo() const {
+        return CODIGO;
+    }
+    
+    /**
+     * @brief Parametros del detector para este tipo
+     * @return Los de configDetector()
+     */
+    ConfigDetector configDetectorTipo() const {
+        return configDetector();
+    }
+    
+    /**
+     * @brief Copia el historial por partes como double
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantas lecturas copie
+     */
+    int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const {
+        return historial.copiarComo(destino, maximo, cursor);
+    }
+    
+    /**
+     * @brief Muestra informacion general del sensor
+     */
+    void imprimirInfo() const {
+        printf("=== Sensor de Humedad ===\n");
+        printf("ID: %s\n", nombre);
+        printf("Lecturas almacenadas: %d\n", historial.obtenerTamanio());
+        if (!historial.estaVacia()) {
+            printf("Promedio actual: %.1f %%\n", historial.calcularPromedio());
+        }
+        if (obtenerDetector() != NULL) {
+            obtenerDetector()->imprimirResumen();
+        }
+    }
+};
+
+#endif // SENSOR_HUMEDAD_H
\ No newline at end of file
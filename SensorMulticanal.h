@@ -0,0 +1,250 @@
+#ifndef SENSOR_MULTICANAL_H
+#define SENSOR_MULTICANAL_H
+
+#include "SensorBase.h"
+#include "ListaSensor.h"
+#include <cstdio>  // Para printf (C puro, sin STL)
+#include "Bitacora.h"
+
+/**
+ * @brief Sensor que entrega varios valores por lectura (una trama)
+ * 
+ * Por ejemplo una estacion que mide temperatura, humedad y presion a la
+ * vez. El historial guarda las tramas intercaladas (canal 0, canal 1,
+ * ..., canal 0, ...), asi que exportar e importar funcionan igual que
+ * con los sensores de un canal. registrarLote recibe los valores en ese
+ * mismo orden y si un lote corta una trama, la guarda hasta completarla.
+ * 
+ * El detector de anomalias revisa el canal 0; si una trama es anomala se
+ * queda fuera completa para no desalinear los canales.
+ * 
+ * @tparam N Cantidad de canales
+ */
+template <int N>
+class SensorMulticanal : public SensorBase {
+public:
+    typedef float Valor;             // Tipo de cada valor en el historial
+    static const char CODIGO = 'M';  // Codigo de tipo (ver RegistroTipos.h)
+    static const int CANALES = N;    // Valores por lectura
+    
+    /**
+     * @brief Parametros del detector de anomalias para el canal 0
+     * @return Configuracion pensada para una temperatura
+     */
+    static ConfigDetector configDetector() {
+        ConfigDetector config;
+        config.cambioMaximo = 5.0;
+        config.desviacionMinima = 0.1;
+        return config;
+    }
+
+private:
+    /** Tramas por tramo al revisar y convertir en la pila */
+    static const int TRAMAS_POR_TRAMO = 64;
+    
+    ListaSensor<Valor> historial;  // Tramas intercaladas
+    double parcial[N];             // Trama incompleta de un lote anterior
+    int enParcial;                 // Canales que ya llegaron de esa trama
+    double sumas[N];               // Suma por canal de las tramas guardadas
+    long long tramas;              // Tramas guardadas
+    double promedios[N];           // Resultado del ultimo procesamiento
+    
+    /**
+     * @brief Revisa, convierte y guarda tramas completas
+     * @param valores Tramas intercaladas
+     * @param cantidad Cuantas tramas
+     * @return Cuantas tramas guarde
+     */
+    int guardarTramas(const double* valores, int cantidad) {
+        float bloque[TRAMAS_POR_TRAMO * N];
+        double principal[TRAMAS_POR_TRAMO];
+        double espacio[TRAMAS_POR_TRAMO];
+        unsigned char descartar[TRAMAS_POR_TRAMO];
+        int guardadas = 0;
+        while (cantidad > 0) {
+            int n = cantidad < TRAMAS_POR_TRAMO ? cantidad : TRAMAS_POR_TRAMO;
+            for (int t = 0; t < n; t++) principal[t] = valores[t * N];
+            marcarDescartes(principal, n, espacio, descartar);
+            
+            int aceptadas = 0;
+            for (int t = 0; t < n; t++) {
+                if (descartar[t]) continue;
+                for (int c = 0; c < N; c++) {
+                    float v = (float)valores[t * N + c];
+                    bloque[aceptadas * N + c] = v;
+                    sumas[c] += v;
+                }
+                aceptadas++;
+            }
+            historial.insertarLote(bloque, aceptadas * N);
+            tramas += aceptadas;
+            guardadas += aceptadas;
+            valores += n * N;
+            cantidad -= n;
+        }
+        return guardadas;
+    }
+
+public:
+    /**
+     * @brief Constructor que crea un sensor multicanal
+     * @param id Identificador unico del sensor
+     */
+    SensorMulticanal(const char* id) : SensorBase(id), enParcial(0), tramas(0) {
+        for (int c = 0; c < N; c++) {
+            sumas[c] = 0.0;
+            promedios[c] = 0.0;
+        }
+        BITACORA("[Sensor Multicanal] Creado: %s (%d canales)\n", nombre, N);  // Sin STL
+    }
+    
+    /**
+     * @brief Destructor que limpia la memoria del historial
+     */
+    ~SensorMulticanal() {
+        BITACORA("[Destructor Sensor] %s - Liberando historial multicanal...\n", nombre);
+    }
+    
+    /**
+     * @brief Agrega una trama completa
+     * @param valores N valores, uno por canal
+     */
+    void registrarLectura(const float* valores) {
+        double trama[N];
+        for (int c = 0; c < N; c++) trama[c] = valores[c];
+        if (guardarTramas(trama, 1) == 0) {
+            BITACORA("[%s] Trama en cuarentena (canal 0: %.2f)\n", nombre, trama[0]);
+            return;
+        }
+        marcarSucio();
+        BITACORA("[%s] Trama de %d canales registrada\n", nombre, N);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega valores intercalados por canal
+     * @param valores Valores en orden (canal 0, canal 1, ...)
+     * @param cantidad Cuantos valores (no tramas)
+     */
+    void registrarLote(const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        
+        int recibidos = cantidad;
+        int guardadas = 0;
+        // Primero completo la trama que dejo cortada el lote anterior
+        if (enParcial > 0) {
+            while (enParcial < N && cantidad > 0) {
+                parcial[enParcial++] = *valores++;
+                cantidad--;
+            }
+            if (enParcial < N) return;
+            guardadas += guardarTramas(parcial, 1);
+            enParcial = 0;
+        }
+        
+        int completas = cantidad / N;
+        guardadas += guardarTramas(valores, completas);
+        for (int i = completas * N; i < cantidad; i++) parcial[enParcial++] = valores[i];
+        
+        if (guardadas > 0) marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Lote de %d valores registrado (%d tramas guardadas)\n", nombre, recibidos, guardadas);  // Sin STL
+    }
+    
+    /**
+     * @brief Procesamiento especifico: promedio de cada canal
+     * 
+     * Las sumas por canal se llevan al registrar, asi que no se recorre
+     * el historial
+     */
+    void procesarLectura() {
+        BITACORA("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
+        
+        if (tramas == 0) {
+            BITACORA("[%s] No hay tramas para procesar.\n", nombre);
+            return;
+        }
+        
+        for (int c = 0; c < N; c++) promedios[c] = sumas[c] / tramas;
+        BITACORA("[Sensor Multicanal] Promedios por canal sobre %lld tramas:", tramas);
+        for (int c = 0; c < N; c++) BITACORA(" %.2f", promedios[c]);
+        BITACORA("\n");
+    }
+    
+    /**
+     * @brief Promedio de un canal en el ultimo procesamiento
+     * @param canal Canal (0 a N-1)
+     * @return Promedio
+     */
+    double obtenerPromedio(int canal) const {
+        return promedios[canal];
+    }
+    
+    /**
+     * @brief Cantidad de valores en el historial (tramas por canales)
+     * @return Tamanio del historial
+     */
+    int obtenerCantidadLecturas() const {
+        return historial.obtenerTamanio();
+    }
+    
+    /**
+     * @brief Memoria del sensor y de su historial
+     * @return Bytes propios
+     */
+    size_t obtenerBytesPropios() const {
+        return sizeof(*this) + historial.bytesUsados() + bytesDetector();
+    }
+    
+    /**
+     * @brief Pasa el historial a la arena de bloques de la lista de gestion
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArenaHistorial(ArenaBloques* arena) {
+        historial.usarArena(arena);
+    }
+    
+    /**
+     * @brief Codigo de tipo para exportar e importar
+     * @return 'M' (multicanal)
+     */
+    char obtenerTipo() const {
+        return CODIGO;
+    }
+    
+    /**
+     * @brief Parametros del detector para este tipo
+     * @return Los de configDetector()
+     */
+    ConfigDetector configDetectorTipo() const {
+        return configDetector();
+    }
+    
+    /**
+     * @brief Copia el historial por partes como double (intercalado)
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantos valores copie
+     */
+    int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const {
+        return historial.copiarComo(destino, maximo, cursor);
+    }
+    
+    /**
+     * @brief Muestra informacion general del sensor
+     */
+    void imprimirInfo() const {
+        printf("=== Sensor Multicanal (%d canales) ===\n", N);
+        printf("ID: %s\n", nombre);
+        printf("Tramas almacenadas: %lld\n", tramas);
+        if (tramas > 0) {
+            printf("Promedio por canal:");
+            for (int c = 0; c < N; c++) printf(" %.2f", sumas[c] / tramas);
+            printf("\n");
+        }
+        if (obtenerDetector() != NULL) {
+            obtenerDetector()->imprimirResumen();
+        }
+    }
+};
+
+#endif // SENSOR_MULTICANAL_H
\ No newline at end of file
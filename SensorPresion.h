@@ -6,6 +6,7 @@
 #include "SensorBase.h"
 #include "ListaSensor.h"
 #include <cstdio>  // Para printf (C puro, sin STL)
+#include "Bitacora.h"
 
 /**
  * @brief Clase concreta para sensores de presion
@@ -13,8 +14,24 @@
  * Hereda de SensorBase e implementa los metodos virtuales puros
  */
 class SensorPresion : public SensorBase {
+public:
+    typedef int Valor;               // Tipo de cada lectura en el historial
+    static const char CODIGO = 'P';  // Codigo de tipo (ver RegistroTipos.h)
+    static const int CANALES = 1;    // Valores por lectura
+    
+    /**
+     * @brief Parametros del detector de anomalias para este tipo
+     * @return Configuracion pensada para presion
+     */
+    static ConfigDetector configDetector() {
+        ConfigDetector config;
+        config.cambioMaximo = 15.0;      // Pa entre dos lecturas seguidas
+        config.desviacionMinima = 1.0;   // Las lecturas son enteras
+        return config;
+    }
+
 private:
-    ListaSensor<int> historial;  // Lista que guarda todas las lecturas de presion
+    ListaSensor<Valor> historial;  // Lista que guarda todas las lecturas de presion
     
 public:
     /**
@@ -23,14 +40,14 @@ public:
      */
     SensorPresion(const char* id) : SensorBase(id) {
         // Llamo al constructor de la clase base para inicializar el nombre
-        printf("[Sensor Presion] Creado: %s\n", nombre);  // Sin STL
+        BITACORA("[Sensor Presion] Creado: %s\n", nombre);  // Sin STL
     }
     
     /**
      * @brief Destructor que limpia la memoria del historial
      */
     ~SensorPresion() {
-        printf("[Destructor Sensor] %s - Liberando historial de presiones...\n", nombre);
+        BITACORA("[Destructor Sensor] %s - Liberando historial de presiones...\n", nombre);
         // El destructor de ListaSensor se encarga de liberar los nodos
     }
     
@@ -39,9 +56,58 @@ public:
      * @param valor La presion leida (en unidades)
      */
     void registrarLectura(int valor) {
+        // Si el detector la toma como anomala no llega al historial
+        if (!admitirLectura(valor)) {
+            BITACORA("[%s] Presion en cuarentena: %d Pa\n", nombre, valor);
+            return;
+        }
+        
         // Inserto el nuevo valor en mi lista
         historial.insertarAlFinal(valor);
-        printf("[%s] Presion registrada: %d Pa\n", nombre, valor);  // Sin STL
+        marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Presion registrada: %d Pa\n", nombre, valor);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega un lote de lecturas al historial
+     * 
+     * Convierte en bloques chicos sobre la pila para no pedir memoria
+     * extra, y engancha cada bloque con una sola insercion.
+     * Si hay detector de anomalias, cada bloque pasa antes por el. Sin
+     * detector tambien se quedan fuera NaN e infinitos (no hay entero
+     * que los represente), y lo que no cabe en un int se satura.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas son
+     */
+    void registrarLote(const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        
+        int bloque[256];
+        double filtrados[256];
+        int hechos = 0;
+        int guardadas = 0;
+        while (hechos < cantidad) {
+            int n = cantidad - hechos;
+            if (n > 256) n = 256;
+            const double* tramo = valores;
+            int filtradas = filtrarAnomalias(tramo, n, filtrados);
+            int aceptadas = 0;
+            for (int i = 0; i < filtradas; i++) {
+                if (!__builtin_isfinite(tramo[i])) continue;
+                // Redondeo al entero mas cercano
+                double v = tramo[i] < 0 ? tramo[i] - 0.5 : tramo[i] + 0.5;
+                if (v > 2147483647.0) v = 2147483647.0;
+                if (v < -2147483648.0) v = -2147483648.0;
+                bloque[aceptadas++] = (int)v;
+            }
+            historial.insertarLote(bloque, aceptadas);
+            guardadas += aceptadas;
+            valores += n;
+            hechos += n;
+        }
+        if (guardadas > 0) marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Lote de %d presiones registrado (%d guardadas)\n", nombre, cantidad, guardadas);  // Sin STL
     }
     
     /**
@@ -52,20 +118,71 @@ public:
     void procesarLectura() {
         // override significa que estoy redefiniendo un metodo virtual de la clase base
         
-        printf("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
+        BITACORA("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
         
         // Verifico que tenga lecturas para procesar
         if (historial.estaVacia()) {
-            printf("[%s] No hay lecturas para procesar.\n", nombre);
+            BITACORA("[%s] No hay lecturas para procesar.\n", nombre);
             return;
         }
         
         // Calculo el promedio de todas las presiones
         double promedio = historial.calcularPromedio();
-        printf("[Sensor Presion] Promedio de presiones: %.2f Pa (sobre %d lecturas)\n",
+        BITACORA("[Sensor Presion] Promedio de presiones: %.2f Pa (sobre %d lecturas)\n",
                promedio, historial.obtenerTamanio());
     }
     
+    /**
+     * @brief Cantidad de lecturas en el historial
+     * @return Tamanio del historial
+     */
+    int obtenerCantidadLecturas() const {
+        return historial.obtenerTamanio();
+    }
+    
+    /**
+     * @brief Memoria del sensor y de su historial
+     * @return Bytes propios
+     */
+    size_t obtenerBytesPropios() const {
+        return sizeof(*this) + historial.bytesUsados() + bytesDetector();
+    }
+    
+    /**
+     * @brief Pasa el historial a la arena de bloques de la lista de gestion
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArenaHistorial(ArenaBloques* arena) {
+        historial.usarArena(arena);
+    }
+    
+    /**
+     * @brief Codigo de tipo para exportar e importar
+     * @return 'P' (presion)
+     */
+    char obtenerTipo() const {
+        return CODIGO;
+    }
+    
+    /**
+     * @brief Parametros del detector para este tipo
+     * @return Los de configDetector()
+     */
+    ConfigDetector configDetectorTipo() const {
+        return configDetector();
+    }
+    
+    /**
+     * @brief Copia el historial por partes como double
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantas lecturas copie
+     */
+    int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const {
+        return historial.copiarComo(destino, maximo, cursor);
+    }
+    
     /**
      * @brief Muestra informacion general del sensor
      */
@@ -76,6 +193,9 @@ public:
         if (!historial.estaVacia()) {
             printf("Promedio actual: %.2f Pa\n", historial.calcularPromedio());
         }
+        if (obtenerDetector() != NULL) {
+            obtenerDetector()->imprimirResumen();
+        }
     }
 };
 
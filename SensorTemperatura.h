@@ -5,6 +5,7 @@
 #include "SensorBase.h"
 #include "ListaSensor.h"
 #include <cstdio>  // Para printf (C puro, sin STL)
+#include "Bitacora.h"
 
 /**
  * @brief Clase concreta para sensores de temperatura
@@ -12,8 +13,24 @@
  * Hereda de SensorBase e implementa los metodos virtuales puros
  */
 class SensorTemperatura : public SensorBase {
+public:
+    typedef float Valor;             // Tipo de cada lectura en el historial
+    static const char CODIGO = 'T';  // Codigo de tipo (ver RegistroTipos.h)
+    static const int CANALES = 1;    // Valores por lectura
+    
+    /**
+     * @brief Parametros del detector de anomalias para este tipo
+     * @return Configuracion pensada para temperatura
+     */
+    static ConfigDetector configDetector() {
+        ConfigDetector config;
+        config.cambioMaximo = 5.0;       // Grados entre dos lecturas seguidas
+        config.desviacionMinima = 0.1;   // Resolucion del sensor
+        return config;
+    }
+
 private:
-    ListaSensor<float> historial;  // Lista que guarda todas las lecturas de temperatura
+    ListaSensor<Valor> historial;  // Lista que guarda todas las lecturas de temperatura
     
 public:
     /**
@@ -22,14 +39,14 @@ public:
      */
     SensorTemperatura(const char* id) : SensorBase(id) {
         // Llamo al constructor de la clase base para inicializar el nombre
-        printf("[Sensor Temperatura] Creado: %s\n", nombre);  // Sin STL
+        BITACORA("[Sensor Temperatura] Creado: %s\n", nombre);  // Sin STL
     }
     
     /**
      * @brief Destructor que limpia la memoria del historial
      */
     ~SensorTemperatura() {
-        printf("[Destructor Sensor] %s - Liberando historial de temperaturas...\n", nombre);
+        BITACORA("[Destructor Sensor] %s - Liberando historial de temperaturas...\n", nombre);
         // El destructor de ListaSensor se encarga de liberar los nodos
     }
     
@@ -38,9 +55,50 @@ public:
      * @param valor La temperatura leida (en grados)
      */
     void registrarLectura(float valor) {
+        // Si el detector la toma como anomala no llega al historial
+        if (!admitirLectura(valor)) {
+            BITACORA("[%s] Temperatura en cuarentena: %.2f C\n", nombre, valor);
+            return;
+        }
+        
         // Inserto el nuevo valor en mi lista
         historial.insertarAlFinal(valor);
-        printf("[%s] Temperatura registrada: %.2f C\n", nombre, valor);  // Sin STL
+        marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Temperatura registrada: %.2f C\n", nombre, valor);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega un lote de lecturas al historial
+     * 
+     * Convierte en bloques chicos sobre la pila para no pedir memoria
+     * extra, y engancha cada bloque con una sola insercion.
+     * Si hay detector de anomalias, cada bloque pasa antes por el.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas son
+     */
+    void registrarLote(const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        
+        float bloque[256];
+        double filtrados[256];
+        int hechos = 0;
+        int guardadas = 0;
+        while (hechos < cantidad) {
+            int n = cantidad - hechos;
+            if (n > 256) n = 256;
+            const double* tramo = valores;
+            int aceptadas = filtrarAnomalias(tramo, n, filtrados);
+            for (int i = 0; i < aceptadas; i++) {
+                bloque[i] = (float)tramo[i];
+            }
+            historial.insertarLote(bloque, aceptadas);
+            guardadas += aceptadas;
+            valores += n;
+            hechos += n;
+        }
+        if (guardadas > 0) marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Lote de %d temperaturas registrado (%d guardadas)\n", nombre, cantidad, guardadas);  // Sin STL
     }
     
     /**
@@ -51,28 +109,79 @@ public:
     void procesarLectura() {
         // override significa que estoy redefiniendo un metodo virtual de la clase base
         
-        printf("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
+        BITACORA("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
         
         // Verifico que tenga lecturas para procesar
         if (historial.estaVacia()) {
-            printf("[%s] No hay lecturas para procesar.\n", nombre);
+            BITACORA("[%s] No hay lecturas para procesar.\n", nombre);
             return;
         }
         
         // Elimino la temperatura mas baja
         float minTemp = historial.eliminarMasBajo();
-        printf("[Sensor Temp] Lectura mas baja eliminada: %.2f C\n", minTemp);
+        BITACORA("[Sensor Temp] Lectura mas baja eliminada: %.2f C\n", minTemp);
         
         // Calculo el promedio de las temperaturas restantes
         if (!historial.estaVacia()) {
             double promedio = historial.calcularPromedio();
-            printf("[Sensor Temp] Promedio de temperaturas restantes: %.2f C (sobre %d lecturas)\n", 
+            BITACORA("[Sensor Temp] Promedio de temperaturas restantes: %.2f C (sobre %d lecturas)\n", 
                    promedio, historial.obtenerTamanio());
         } else {
-            printf("[Sensor Temp] No quedan lecturas despues de eliminar el minimo.\n");
+            BITACORA("[Sensor Temp] No quedan lecturas despues de eliminar el minimo.\n");
         }
     }
     
+    /**
+     * @brief Cantidad de lecturas en el historial
+     * @return Tamanio del historial
+     */
+    int obtenerCantidadLecturas() const {
+        return historial.obtenerTamanio();
+    }
+    
+    /**
+     * @brief Memoria del sensor y de su historial
+     * @return Bytes propios
+     */
+    size_t obtenerBytesPropios() const {
+        return sizeof(*this) + historial.bytesUsados() + bytesDetector();
+    }
+    
+    /**
+     * @brief Pasa el historial a la arena de bloques de la lista de gestion
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArenaHistorial(ArenaBloques* arena) {
+        historial.usarArena(arena);
+    }
+    
+    /**
+     * @brief Codigo de tipo para exportar e importar
+     * @return 'T' (temperatura)
+     */
+    char obtenerTipo() const {
+        return CODIGO;
+    }
+    
+    /**
+     * @brief Parametros del detector para este tipo
+     * @return Los de configDetector()
+     */
+    ConfigDetector configDetectorTipo() const {
+        return configDetector();
+    }
+    
+    /**
+     * @brief Copia el historial por partes como double
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantas lecturas copie
+     */
+    int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const {
+        return historial.copiarComo(destino, maximo, cursor);
+    }
+    
     /**
      * @brief Muestra informacion general del sensor
      */
@@ -83,6 +192,9 @@ public:
         if (!historial.estaVacia()) {
             printf("Promedio actual: %.2f C\n", historial.calcularPromedio());
         }
+        if (obtenerDetector() != NULL) {
+            obtenerDetector()->imprimirResumen();
+        }
     }
 };
 
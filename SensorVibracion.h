@@ -0,0 +1,361 @@
+#ifndef SENSOR_VIBRACION_H
+#define SENSOR_VIBRACION_H
+
+#include "SensorBase.h"
+#include "ListaSensor.h"
+#include <cstdio>   // Para printf (C puro, sin STL)
+#include <cstring>  // Para memcpy
+#include <cmath>    // Para sqrt, HUGE_VAL
+#include "Bitacora.h"
+
+/** @brief Ocho muestras de 16 bits en un vector (extension de GCC/Clang) */
+typedef short VectorCorto __attribute__((vector_size(16)));
+
+/** @brief Ocho enteros de 32 bits (los cuadrados de un VectorCorto caben sin desbordar) */
+typedef int VectorEntero __attribute__((vector_size(32)));
+
+/** @brief Ocho enteros de 64 bits para acumular los cuadrados */
+typedef long long VectorLargo __attribute__((vector_size(64)));
+
+/**
+ * @brief Energia y extremos de un tramo de muestras (nucleo de RMS y pico)
+ * 
+ * La suma de cuadrados es entera y exacta: cada cuadrado es a lo mas
+ * 2^30, asi que no se desborda antes de 2^33 muestras.
+ */
+struct EnergiaVibracion {
+    long long muestras;       // Muestras acumuladas
+    long long sumaCuadrados;  // Suma de x^2
+    int maximo;               // Muestra mas alta
+    int minimo;               // Muestra mas baja
+    
+    /**
+     * @brief Constructor que deja la energia en cero
+     */
+    EnergiaVibracion() {
+        reiniciar();
+    }
+    
+    /**
+     * @brief Olvida lo acumulado
+     */
+    void reiniciar() {
+        muestras = 0;
+        sumaCuadrados = 0;
+        maximo = -32768;
+        minimo = 32767;
+    }
+    
+    /**
+     * @brief Suma un tramo de muestras
+     * 
+     * Ocho muestras por vuelta con vectores de GCC: el compilador no
+     * vectoriza solo la suma que se ensancha a 64 bits. Maximo y minimo
+     * se llevan por carril y se juntan al final.
+     * 
+     * @param x Muestras
+     * @param n Cuantas son
+     */
+    void acumular(const short* x, int n) {
+        const int ANCHO = sizeof(VectorCorto) / sizeof(short);
+        int i = 0;
+        if (n >= ANCHO) {
+            VectorLargo suma = {0, 0, 0, 0, 0, 0, 0, 0};
+            VectorCorto mayor;
+            memcpy(&mayor, x, sizeof(mayor));  // Carga sin exigir alineacion
+            VectorCorto menor = mayor;
+            for (; i + ANCHO <= n; i += ANCHO) {
+                VectorCorto v;
+                memcpy(&v, x + i, sizeof(v));
+                VectorEntero e = __builtin_convertvector(v, VectorEntero);
+                suma += __builtin_convertvector(e * e, VectorLargo);
+                mayor = v > mayor ? v : mayor;
+                menor = v < menor ? v : menor;
+            }
+            for (int k = 0; k < ANCHO; k++) {
+                sumaCuadrados += suma[k];
+                if (mayor[k] > maximo) maximo = mayor[k];
+                if (menor[k] < minimo) minimo = menor[k];
+            }
+        }
+        for (; i < n; i++) {
+            int v = x[i];
+            sumaCuadrados += (long long)(v * v);
+            if (v > maximo) maximo = v;
+            if (v < minimo) minimo = v;
+        }
+        muestras += n;
+    }
+    
+    /**
+     * @brief Raiz del promedio de los cuadrados
+     * @return RMS en cuentas, 0 si no hay muestras
+     */
+    double rms() const {
+        return muestras == 0 ? 0.0 : sqrt((double)sumaCuadrados / (double)muestras);
+    }
+    
+    /**
+     * @brief Mayor amplitud absoluta
+     * @return Pico en cuentas, 0 si no hay muestras
+     */
+    int pico() const {
+        if (muestras == 0) return 0;
+        return maximo > -minimo ? maximo : -minimo;
+    }
+};
+
+/**
+ * @brief Clase concreta para acelerometros que mandan rafagas de 16 bits
+ * 
+ * Pensado para muestreo rapido (10 kHz o mas): las muestras entran por
+ * rafagas con registrarMuestras, que las copia tal cual a los bloques
+ * del historial y en la misma pasada acumula la energia. Procesar solo
+ * saca el RMS y el pico de lo que llego desde la ultima vez, asi que no
+ * recorre el historial.
+ */
+class SensorVibracion : public SensorBase {
+public:
+    typedef short Valor;             // Tipo de cada lectura en el historial
+    static const char CODIGO = 'V';  // Codigo de tipo (ver RegistroTipos.h)
+    static const int CANALES = 1;    // Valores por lectura
+    
+    /**
+     * @brief Parametros del detector de anomalias para este tipo
+     * 
+     * La senal oscila alrededor de cero, asi que solo uso el z-score
+     * sobre una ventana larga, sin limite de cambio ni EWMA. Los golpes
+     * se marcan pero no se quitan: sacar muestras deforma la onda.
+     * 
+     * @return Configuracion pensada para vibracion
+     */
+    static ConfigDetector configDetector() {
+        ConfigDetector config;
+        config.ventana = 1024;          // 0.1 s a 10 kHz
+        config.minimoMuestras = 256;
+        config.umbralZ = 6.0;
+        config.umbralEwma = HUGE_VAL;
+        config.desviacionMinima = 1.0;  // Las muestras son enteras
+        config.rachaMaxima = 64;
+        config.cuarentena = false;
+        return config;
+    }
+
+private:
+    ListaSensor<Valor> historial;  // Todas las muestras en orden de llegada
+    EnergiaVibracion ventana;      // Lo que llego desde el ultimo procesamiento
+    double ultimoRms;              // Resultado del ultimo procesamiento
+    int ultimoPico;
+    
+    /**
+     * @brief Guarda muestras ya revisadas y acumula su energia
+     * @param muestras Muestras en orden
+     * @param cantidad Cuantas son
+     */
+    void guardar(const short* muestras, int cantidad) {
+        historial.insertarLote(muestras, cantidad);
+        ventana.acumular(muestras, cantidad);
+    }
+
+public:
+    /**
+     * @brief Constructor que crea un sensor de vibracion
+     * @param id Identificador unico del sensor
+     */
+    SensorVibracion(const char* id) : SensorBase(id), ultimoRms(0.0), ultimoPico(0) {
+        BITACORA("[Sensor Vibracion] Creado: %s\n", nombre);  // Sin STL
+    }
+    
+    /**
+     * @brief Destructor que limpia la memoria del historial
+     */
+    ~SensorVibracion() {
+        BITACORA("[Destructor Sensor] %s - Liberando historial de vibraciones...\n", nombre);
+    }
+    
+    /**
+     * @brief Agrega una sola muestra
+     * @param valor Muestra en cuentas del convertidor
+     */
+    void registrarLectura(short valor) {
+        if (!admitirLectura(valor)) {
+            BITACORA("[%s] Vibracion en cuarentena: %d\n", nombre, valor);
+            return;
+        }
+        guardar(&valor, 1);
+        marcarSucio();
+        BITACORA("[%s] Vibracion registrada: %d\n", nombre, valor);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega una rafaga de muestras de 16 bits sin convertirlas
+     * 
+     * Es el camino rapido: sin detector las muestras se copian directo a
+     * los bloques. Con detector pasan por registrarLote (que las revisa
+     * como double).
+     * 
+     * @param muestras Muestras en orden de llegada
+     * @param cantidad Cuantas son
+     */
+    void registrarMuestras(const short* muestras, int cantidad) {
+        if (cantidad <= 0) return;
+        if (obtenerDetector() != NULL) {
+            double tramo[256];
+            for (int hechos = 0; hechos < cantidad; hechos += 256) {
+                int n = cantidad - hechos < 256 ? cantidad - hechos : 256;
+                for (int i = 0; i < n; i++) tramo[i] = muestras[hechos + i];
+                registrarLote(tramo, n);
+            }
+            return;
+        }
+        guardar(muestras, cantidad);
+        marcarSucio();
+        BITACORA("[%s] Rafaga de %d muestras registrada\n", nombre, cantidad);  // Sin STL
+    }
+    
+    /**
+     * @brief Agrega un lote de lecturas al historial
+     * 
+     * Redondea y satura cada lectura a 16 bits en bloques chicos sobre la
+     * pila. Si hay detector de anomalias, cada bloque pasa antes por el;
+     * sin detector tambien se quedan fuera NaN e infinitos.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param cantidad Cuantas lecturas son
+     */
+    void registrarLote(const double* valores, int cantidad) {
+        if (cantidad <= 0) return;
+        
+        short bloque[256];
+        double filtrados[256];
+        int hechos = 0;
+        int guardadas = 0;
+        while (hechos < cantidad) {
+            int n = cantidad - hechos;
+            if (n > 256) n = 256;
+            const double* tramo = valores;
+            int filtradas = filtrarAnomalias(tramo, n, filtrados);
+            int aceptadas = 0;
+            for (int i = 0; i < filtradas; i++) {
+                if (!__builtin_isfinite(tramo[i])) continue;
+                double v = tramo[i] < 0 ? tramo[i] - 0.5 : tramo[i] + 0.5;
+                if (v > 32767) v = 32767;
+                if (v < -32768) v = -32768;
+                bloque[aceptadas++] = (short)v;
+            }
+            guardar(bloque, aceptadas);
+            guardadas += aceptadas;
+            valores += n;
+            hechos += n;
+        }
+        if (guardadas > 0) marcarSucio();  // Aviso que tengo lecturas nuevas por procesar
+        BITACORA("[%s] Lote de %d vibraciones registrado (%d guardadas)\n", nombre, cantidad, guardadas);  // Sin STL
+    }
+    
+    /**
+     * @brief Procesamiento especifico para vibracion
+     * 
+     * Saca el RMS y el pico de las muestras que llegaron desde el ultimo
+     * procesamiento (ya acumulados al registrar) y empieza otra ventana
+     */
+    void procesarLectura() {
+        BITACORA("\n-> Procesando Sensor %s...\n", nombre);  // Sin STL
+        
+        if (ventana.muestras == 0) {
+            BITACORA("[%s] No hay muestras nuevas para procesar.\n", nombre);
+            return;
+        }
+        
+        ultimoRms = ventana.rms();
+        ultimoPico = ventana.pico();
+        BITACORA("[Sensor Vibracion] RMS: %.1f, pico: %d (sobre %lld muestras nuevas)\n",
+                 ultimoRms, ultimoPico, ventana.muestras);
+        ventana.reiniciar();
+    }
+    
+    /**
+     * @brief RMS del ultimo procesamiento
+     * @return RMS en cuentas
+     */
+    double obtenerUltimoRms() const {
+        return ultimoRms;
+    }
+    
+    /**
+     * @brief Pico del ultimo procesamiento
+     * @return Pico en cuentas
+     */
+    int obtenerUltimoPico() const {
+        return ultimoPico;
+    }
+    
+    /**
+     * @brief Cantidad de muestras en el historial
+     * @return Tamanio del historial
+     */
+    int obtenerCantidadLecturas() const {
+        return historial.obtenerTamanio();
+    }
+    
+    /**
+     * @brief Memoria del sensor y de su historial
+     * @return Bytes propios
+     */
+    size_t obtenerBytesPropios() const {
+        return sizeof(*this) + historial.bytesUsados() + bytesDetector();
+    }
+    
+    /**
+     * @brief Pasa el historial a la arena de bloques de la lista de gestion
+     * @param arena Arena de bloques, NULL para pedirlos sueltos
+     */
+    void usarArenaHistorial(ArenaBloques* arena) {
+        historial.usarArena(arena);
+    }
+    
+    /**
+     * @brief Codigo de tipo para exportar e importar
+     * @return 'V' (vibracion)
+     */
+    char obtenerTipo() const {
+        return CODIGO;
+    }
+    
+    /**
+     * @brief Parametros del detector para este tipo
+     * @return Los de configDetector()
+     */
+    ConfigDetector configDetectorTipo() const {
+        return configDetector();
+    }
+    
+    /**
+     * @brief Copia el historial por partes como double
+     * @param destino Arreglo destino
+     * @param maximo Espacio disponible
+     * @param cursor Posicion de lectura
+     * @return Cuantas lecturas copie
+     */
+    int copiarLecturas(double* destino, int maximo, CursorLecturas& cursor) const {
+        return historial.copiarComo(destino, maximo, cursor);
+    }
+    
+    /**
+     * @brief Muestra informacion general del sensor
+     */
+    void imprimirInfo() const {
+        printf("=== Sensor de Vibracion ===\n");
+        printf("ID: %s\n", nombre);
+        printf("Muestras almacenadas: %d\n", historial.obtenerTamanio());
+        printf("Ultimo procesamiento: RMS %.1f, pico %d\n", ultimoRms, ultimoPico);
+        if (ventana.muestras > 0) {
+            printf("Sin procesar: %lld muestras (RMS %.1f, pico %d)\n",
+                   ventana.muestras, ventana.rms(), ventana.pico());
+        }
+        if (obtenerDetector() != NULL) {
+            obtenerDetector()->imprimirResumen();
+        }
+    }
+};
+
+#endif // SENSOR_VIBRACION_H
\ No newline at end of file
@@ -4,8 +4,9 @@
 #define SIMULADOR_ARDUINO_H
 
 #include <cstdio>   // Para printf (C puro, sin STL)
-#include <cstdlib>  // Para rand, srand (C puro)
+#include <cstdlib>  // Para rand, srand, rand_r (C puro)
 #include <ctime>    // Para time (C puro)
+#include <cmath>    // Para sin
 
 /**
  * @brief Clase que simula la recepcion de datos desde un Arduino
@@ -17,6 +18,7 @@
 class SimuladorArduino {
 private:
     bool inicializado;  // Bandera para saber si ya inicialice el generador
+    unsigned semilla;   // Semilla de los generadores por tipo (rand_r)
     
 public:
     /**
@@ -25,9 +27,82 @@ public:
     SimuladorArduino() : inicializado(false) {
         // Inicializo el generador de numeros aleatorios
         srand(time(NULL));
+        semilla = (unsigned)time(NULL);
         printf("[Arduino] Simulador inicializado.\n");  // Sin STL
     }
     
+    /**
+     * @brief Semilla para los generadores de cada tipo de sensor
+     * @return Referencia a la semilla (cada generador la avanza)
+     */
+    unsigned& semillaSimulacion() {
+        return semilla;
+    }
+    
+    /**
+     * @brief Genera una temperatura sin imprimir (mismo rango que leerTemperatura)
+     * @param s Semilla de rand_r
+     * @return Temperatura entre 15.0 y 45.0 grados
+     */
+    static double generarTemperatura(unsigned& s) {
+        return 15.0 + (rand_r(&s) % 300) / 10.0;
+    }
+    
+    /**
+     * @brief Genera una presion sin imprimir (mismo rango que leerPresion)
+     * @param s Semilla de rand_r
+     * @return Presion entre 70 y 110 Pa
+     */
+    static double generarPresion(unsigned& s) {
+        return 70 + rand_r(&s) % 41;
+    }
+    
+    /**
+     * @brief Genera una humedad relativa sin imprimir
+     * @param s Semilla de rand_r
+     * @return Humedad entre 30.0 y 90.0 %
+     */
+    static double generarHumedad(unsigned& s) {
+        return 30.0 + (rand_r(&s) % 600) / 10.0;
+    }
+    
+    /**
+     * @brief Genera una muestra suelta de vibracion (ruido del acelerometro)
+     * @param s Semilla de rand_r
+     * @return Muestra entre -2000 y 2000 cuentas
+     */
+    static double generarVibracion(unsigned& s) {
+        return (int)(rand_r(&s) % 4001) - 2000;
+    }
+    
+    /**
+     * @brief Genera una rafaga de vibracion: un tono con ruido y golpes
+     * 
+     * Es lo que manda un acelerometro de 16 bits muestreando rapido: una
+     * senoidal de la frecuencia pedida, ruido y de vez en cuando un golpe
+     * que satura. No imprime nada (son miles de muestras por segundo).
+     * 
+     * @param destino Donde dejo las muestras
+     * @param cantidad Cuantas muestras
+     * @param inicio Numero de la primera muestra (para continuar la fase)
+     * @param muestreoHz Muestras por segundo
+     * @param tonoHz Frecuencia del tono
+     * @param amplitud Amplitud del tono en cuentas
+     * @param s Semilla de rand_r
+     */
+    static void generarRafagaVibracion(short* destino, int cantidad, long long inicio,
+                                       double muestreoHz, double tonoHz, double amplitud,
+                                       unsigned& s) {
+        double paso = 2.0 * 3.14159265358979 * tonoHz / muestreoHz;
+        for (int i = 0; i < cantidad; i++) {
+            double v = amplitud * sin(paso * (double)(inicio + i)) + (int)(rand_r(&s) % 201) - 100;
+            if (rand_r(&s) % 5000 == 0) v = (rand_r(&s) % 2 == 0) ? 32767 : -32768;  // Golpe
+            if (v > 32767) v = 32767;
+            if (v < -32768) v = -32768;
+            destino[i] = (short)v;
+        }
+    }
+    
     /**
      * @brief Simula la lectura de un valor de temperatura
      * @return Temperatura simulada entre 15.0 y 45.0 grados
@@ -72,6 +147,47 @@ public:
         }
     }
     
+    /**
+     * @brief Genera una serie de lecturas con picos inyectados
+     * 
+     * La senal es una rampa lenta con ruido chico (como un sensor real que
+     * cambia poco entre lecturas); sobre ella pongo picos de la amplitud
+     * pedida hacia arriba o hacia abajo. No imprime nada: es para pruebas
+     * y benchmarks con millones de lecturas.
+     * 
+     * @param destino Arreglo donde escribo las lecturas
+     * @param cantidad Cuantas lecturas genero
+     * @param base Valor central de la senal (ej: 25 C o 90 Pa)
+     * @param ruido Amplitud maxima del ruido normal
+     * @param picosPorMil Cuantos picos por cada mil lecturas
+     * @param amplitud Tamanio de los picos
+     * @param esPico Salida opcional: 1 donde inyecte un pico (puede ser NULL)
+     * @param semilla Semilla para repetir la misma serie
+     * @return Cuantos picos inyecte
+     */
+    static int generarSerieConPicos(double* destino, int cantidad, double base, double ruido,
+                                    int picosPorMil, double amplitud, unsigned char* esPico,
+                                    unsigned semilla) {
+        int picos = 0;
+        double nivel = base;
+        for (int i = 0; i < cantidad; i++) {
+            // Deriva lenta acotada a +-2 ruidos alrededor de la base
+            nivel += ruido * 0.05 * ((rand_r(&semilla) % 201) - 100) / 100.0;
+            if (nivel > base + 2 * ruido) nivel = base + 2 * ruido;
+            if (nivel < base - 2 * ruido) nivel = base - 2 * ruido;
+            
+            double valor = nivel + ruido * ((rand_r(&semilla) % 201) - 100) / 100.0;
+            bool pico = (int)(rand_r(&semilla) % 1000) < picosPorMil;
+            if (pico) {
+                valor += (rand_r(&semilla) % 2 == 0) ? amplitud : -amplitud;
+                picos++;
+            }
+            destino[i] = valor;
+            if (esPico != NULL) esPico[i] = pico ? 1 : 0;
+        }
+        return picos;
+    }
+    
     /**
      * @brief Muestra informacion del puerto serial (simulado)
      */
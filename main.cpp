@@ -6,11 +6,14 @@
  */
 
 #include <cstdio>   // Para scanf, printf (C puro)
+#include <cstdlib>  // Para malloc, free (C puro)
 #include <cstring>  // Para strcmp (C puro)
 #include "ListaGestion.h"
-#include "SensorTemperatura.h"
-#include "SensorPresion.h"
+#include "RegistroTipos.h"
 #include "SimuladorArduino.h"
+#include "Benchmarks.h"
+#include "ExportadorColumnar.h"
+#include "PlanificadorDispositivos.h"
 
 /**
  * @brief Limpia el buffer de entrada para evitar problemas con scanf
@@ -20,6 +23,45 @@ void limpiarBuffer() {
     while ((c = getchar()) != '\n' && c != EOF);  // Limpio hasta encontrar newline
 }
 
+#if PLANIFICADOR_DISPONIBLE
+/**
+ * @brief Da de alta un dispositivo de sondeo para cada sensor
+ * @param sensor Sensor visitado
+ * @param contexto Apuntador al PlanificadorDispositivos
+ */
+void agregarSondeo(SensorBase* sensor, void* contexto) {
+    PlanificadorDispositivos* planificador = (PlanificadorDispositivos*)contexto;
+    planificador->agregarDispositivoSondeo(sensor->obtenerNombre(), 100000000LL, 5);  // 5 lecturas cada 100 ms
+}
+#endif
+
+/**
+ * @brief Pide el ID de un sensor registrado
+ * @param sistema Lista de gestion
+ * @param tipo Salida: tipo del sensor en el registro
+ * @return El sensor, NULL si no existe o su tipo no esta registrado
+ */
+SensorBase* pedirSensor(ListaGestion* sistema, const TipoSensor*& tipo) {
+    char id[50];
+    printf("\nIngresa el ID del sensor: ");
+    scanf("%49s", id);
+    limpiarBuffer();
+    
+    SensorBase* sensor = sistema->buscarSensor(id);
+    if (sensor == NULL) {
+        printf("[Error] Sensor no encontrado.\n");
+        return NULL;
+    }
+    
+    // El registro me dice como tratar al sensor sin hacer downcasting
+    tipo = RegistroTipos::buscar(sensor->obtenerTipo());
+    if (tipo == NULL) {
+        printf("[Error] Tipo de sensor desconocido.\n");
+        return NULL;
+    }
+    return sensor;
+}
+
 /**
  * @brief Muestra el menu principal del sistema
  */
@@ -27,13 +69,20 @@ void mostrarMenu() {
     printf("\n========================================\n");
     printf("   Sistema IoT - Gestion de Sensores   \n");
     printf("========================================\n");
-    printf("1. Crear Sensor de Temperatura\n");
-    printf("2. Crear Sensor de Presion\n");
+    printf("1. Crear Sensor (cualquier tipo registrado)\n");
+    printf("2. Ver Tipos de Sensor\n");
     printf("3. Registrar Lectura Manual\n");
     printf("4. Simular Lecturas desde Arduino\n");
     printf("5. Procesar Todos los Sensores (Polimorfismo)\n");
     printf("6. Mostrar Info de Todos los Sensores\n");
     printf("7. Info del Puerto Serial\n");
+    printf("8. Reporte de Metricas\n");
+    printf("9. Exportar Historiales (binario por columnas)\n");
+    printf("10. Importar Historiales\n");
+    printf("11. Activar/Desactivar Deteccion de Anomalias\n");
+#if PLANIFICADOR_DISPONIBLE
+    printf("12. Sondear Todos los Sensores en Paralelo\n");
+#endif
     printf("0. Salir (Liberar Memoria)\n");
     printf("========================================\n");
     printf("Opcion: ");
@@ -41,12 +90,32 @@ void mostrarMenu() {
 
 /**
  * @brief Funcion principal del programa
+ * 
+ * Si se llama como "programa --bench <nombre> [parametros]" corre un
+ * benchmark en lugar del menu interactivo. Opciones para el menu:
+ *   --manifiesto <ruta>  registra de un jalon los sensores del manifiesto
+ *   --salida-rapida      al salir no libera la memoria (la recupera el
+ *                        sistema operativo); no usar con ASan
+ * 
+ * @param argc Cantidad de argumentos
+ * @param argv Argumentos de la linea de comandos
  * @return 0 si todo sale bien
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        return ejecutarBenchmark(argc - 2, argv + 2);
+    }
+    
     // Creo la lista principal que manejara todos los sensores
     // Esta usa polimorfismo para guardar diferentes tipos de sensores
     ListaGestion* sistema = new ListaGestion();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--manifiesto") == 0 && i + 1 < argc) {
+            sistema->cargarManifiesto(argv[++i]);
+        } else if (strcmp(argv[i], "--salida-rapida") == 0) {
+            sistema->fijarModoCierre(CIERRE_SALIDA);
+        }
+    }
     
     // Creo el simulador de Arduino
     SimuladorArduino arduino;
@@ -71,37 +140,39 @@ int main() {
         // Proceso la opcion seleccionada
         switch (opcion) {
             case 1: {
-                // Crear sensor de temperatura
+                // Crear un sensor de cualquier tipo del registro
+                RegistroTipos::imprimir();
+                char codigo;
+                printf("\nIngresa el codigo del tipo: ");
+                if (scanf(" %c", &codigo) != 1) {
+                    printf("[Error] Tipo invalido.\n");
+                    limpiarBuffer();
+                    break;
+                }
+                limpiarBuffer();
+                
+                const TipoSensor* tipo = RegistroTipos::buscar(codigo);
+                if (tipo == NULL) {
+                    printf("[Error] No hay un tipo de sensor '%c'.\n", codigo);
+                    break;
+                }
+                
                 char id[50];
-                printf("\nIngresa el ID del sensor (ej: T-001): ");
+                printf("Ingresa el ID del sensor (ej: %c-001): ", codigo);
                 scanf("%49s", id);  // Leo sin espacios
                 limpiarBuffer();
                 
-                // Creo el sensor usando new (memoria dinamica)
-                SensorTemperatura* nuevoSensor = new SensorTemperatura(id);
-                
-                // Lo agrego a la lista de gestion usando polimorfismo
-                // Guardo el puntero como SensorBase* aunque sea SensorTemperatura*
-                sistema->agregarSensor(nuevoSensor);
+                // Creo el sensor usando new (memoria dinamica) y lo agrego a
+                // la lista de gestion como SensorBase* (polimorfismo)
+                sistema->agregarSensor(tipo->crear(id));
                 
-                printf("Sensor creado exitosamente!\n");
+                printf("Sensor de %s creado exitosamente!\n", tipo->nombre);
                 break;
             }
             
             case 2: {
-                // Crear sensor de presion
-                char id[50];
-                printf("\nIngresa el ID del sensor (ej: P-105): ");
-                scanf("%49s", id);
-                limpiarBuffer();
-                
-                // Creo el sensor usando new (memoria dinamica)
-                SensorPresion* nuevoSensor = new SensorPresion(id);
-                
-                // Lo agrego a la lista de gestion usando polimorfismo
-                sistema->agregarSensor(nuevoSensor);
-                
-                printf("Sensor creado exitosamente!\n");
+                // Mostrar los tipos que conoce el registro
+                RegistroTipos::imprimir();
                 break;
             }
             
@@ -112,55 +183,29 @@ int main() {
                     break;
                 }
                 
-                char id[50];
-                printf("\nIngresa el ID del sensor: ");
-                scanf("%49s", id);
-                limpiarBuffer();
-                
-                // Busco el sensor en la lista
-                SensorBase* sensor = sistema->buscarSensor(id);
+                const TipoSensor* tipo = NULL;
+                SensorBase* sensor = pedirSensor(sistema, tipo);
+                if (sensor == NULL) break;
                 
-                if (sensor == NULL) {
-                    printf("[Error] Sensor no encontrado.\n");
-                    break;
+                // Una lectura son tantos valores como canales tenga el tipo
+                double valores[TipoSensor::MAXIMO_CANALES];
+                if (tipo->canales == 1) {
+                    printf("Ingresa la lectura de %s en %s (%s): ", tipo->nombre, tipo->unidad,
+                           tipo->entero ? "int" : "float");
+                } else {
+                    printf("Ingresa los %d valores de %s [%s]: ", tipo->canales, tipo->nombre, tipo->unidad);
                 }
-                
-                // Ahora necesito saber de que tipo es el sensor para registrar correctamente
-                // Uso dynamic_cast para hacer downcasting seguro
-                
-                SensorTemperatura* tempSensor = dynamic_cast<SensorTemperatura*>(sensor);
-                if (tempSensor != NULL) {
-                    // Es un sensor de temperatura
-                    float valor;
-                    printf("Ingresa la temperatura (float): ");
-                    if (scanf("%f", &valor) != 1) {
-                        printf("[Error] Valor invalido.\n");
-                        limpiarBuffer();
-                        break;
-                    }
-                    limpiarBuffer();
-                    
-                    tempSensor->registrarLectura(valor);
-                    break;
+                bool valido = true;
+                for (int c = 0; c < tipo->canales && valido; c++) {
+                    valido = scanf("%lf", &valores[c]) == 1;
                 }
-                
-                SensorPresion* presSensor = dynamic_cast<SensorPresion*>(sensor);
-                if (presSensor != NULL) {
-                    // Es un sensor de presion
-                    int valor;
-                    printf("Ingresa la presion (int): ");
-                    if (scanf("%d", &valor) != 1) {
-                        printf("[Error] Valor invalido.\n");
-                        limpiarBuffer();
-                        break;
-                    }
-                    limpiarBuffer();
-                    
-                    presSensor->registrarLectura(valor);
+                limpiarBuffer();
+                if (!valido) {
+                    printf("[Error] Valor invalido.\n");
                     break;
                 }
                 
-                printf("[Error] Tipo de sensor desconocido.\n");
+                sensor->registrarLote(valores, tipo->canales);
                 break;
             }
             case 4: {
@@ -170,21 +215,11 @@ int main() {
                     break;
                 }
                 
-                char id[50];
-                int cantidad;
-                
-                printf("\nIngresa el ID del sensor: ");
-                scanf("%49s", id);
-                limpiarBuffer();
-                
-                // Busco el sensor
-                SensorBase* sensor = sistema->buscarSensor(id);
-                
-                if (sensor == NULL) {
-                    printf("[Error] Sensor no encontrado.\n");
-                    break;
-                }
+                const TipoSensor* tipo = NULL;
+                SensorBase* sensor = pedirSensor(sistema, tipo);
+                if (sensor == NULL) break;
                 
+                int cantidad;
                 printf("Cuantas lecturas quieres simular? ");
                 if (scanf("%d", &cantidad) != 1 || cantidad <= 0) {
                     printf("[Error] Cantidad invalida.\n");
@@ -193,28 +228,18 @@ int main() {
                 }
                 limpiarBuffer();
                 
-                // Verifico el tipo y simulo las lecturas
-                SensorTemperatura* tempSensor = dynamic_cast<SensorTemperatura*>(sensor);
-                if (tempSensor != NULL) {
-                    printf("\n[Simulacion] Generando %d lecturas de temperatura...\n", cantidad);
-                    for (int i = 0; i < cantidad; i++) {
-                        float temp = arduino.leerTemperatura();
-                        tempSensor->registrarLectura(temp);
-                    }
-                    break;
+                // Genero todas con el simulador del tipo y las registro en un lote
+                printf("\n[Simulacion] Generando %d lecturas de %s...\n", cantidad, tipo->nombre);
+                double* valores = (double*)malloc(sizeof(double) * cantidad * tipo->canales);
+                for (int i = 0; i < cantidad; i++) {
+                    double* lectura = valores + i * tipo->canales;
+                    tipo->simular(arduino.semillaSimulacion(), lectura);
+                    printf("[Arduino] Lectura de %s:", tipo->nombre);
+                    for (int c = 0; c < tipo->canales; c++) printf(tipo->entero ? " %.0f" : " %.2f", lectura[c]);
+                    printf(" %s\n", tipo->unidad);
                 }
-                
-                SensorPresion* presSensor = dynamic_cast<SensorPresion*>(sensor);
-                if (presSensor != NULL) {
-                    printf("\n[Simulacion] Generando %d lecturas de presion...\n", cantidad);
-                    for (int i = 0; i < cantidad; i++) {
-                        int pres = arduino.leerPresion();
-                        presSensor->registrarLectura(pres);
-                    }
-                    break;
-                }
-                
-                printf("[Error] Tipo de sensor desconocido.\n");
+                sensor->registrarLote(valores, cantidad * tipo->canales);
+                free(valores);
                 break;
             }
             
@@ -248,6 +273,88 @@ int main() {
                 break;
             }
             
+            case 8: {
+                // Mostrar contadores y latencias de las operaciones
+                Metricas::imprimirReporte();
+                sistema->imprimirLongitudes();
+                sistema->imprimirMemoria();
+                break;
+            }
+            
+            case 9: {
+                // Exportar todos los historiales a un archivo
+                if (sistema->obtenerTamanio() == 0) {
+                    printf("\n[Aviso] No hay sensores para exportar.\n");
+                    break;
+                }
+                
+                char ruta[256];
+                printf("\nIngresa el archivo destino: ");
+                scanf("%255s", ruta);
+                limpiarBuffer();
+                
+                long long bytes = ExportadorColumnar::exportar(*sistema, ruta);
+                if (bytes >= 0) {
+                    printf("Exportacion completa: %lld bytes.\n", bytes);
+                }
+                break;
+            }
+            
+            case 10: {
+                // Cargar historiales desde un archivo exportado
+                char ruta[256];
+                printf("\nIngresa el archivo a importar: ");
+                scanf("%255s", ruta);
+                limpiarBuffer();
+                
+                long long lecturas = ExportadorColumnar::importar(*sistema, ruta);
+                if (lecturas >= 0) {
+                    printf("Importacion completa: %lld lecturas.\n", lecturas);
+                }
+                break;
+            }
+            
+            case 11: {
+                // Prender o apagar el detector de anomalias de un sensor
+                char id[50];
+                printf("\nIngresa el ID del sensor: ");
+                scanf("%49s", id);
+                limpiarBuffer();
+                
+                SensorBase* sensor = sistema->buscarSensor(id);
+                if (sensor == NULL) {
+                    printf("[Error] Sensor no encontrado.\n");
+                    break;
+                }
+                
+                if (sensor->obtenerDetector() == NULL) {
+                    sensor->activarDeteccion();
+                    const ConfigDetector& config = sensor->obtenerDetector()->obtenerConfig();
+                    printf("Deteccion activada: ventana %d, z > %.1f, cambio maximo %.1f (anomalias en cuarentena)\n",
+                           config.ventana, config.umbralZ, config.cambioMaximo);
+                } else {
+                    sensor->obtenerDetector()->imprimirResumen();
+                    sensor->desactivarDeteccion();
+                    printf("Deteccion desactivada.\n");
+                }
+                break;
+            }
+            
+#if PLANIFICADOR_DISPONIBLE
+            case 12: {
+                // Todos los sensores leen a la vez, cada uno como una corrutina
+                if (sistema->obtenerTamanio() == 0) {
+                    printf("[Error] No hay sensores registrados.\n");
+                    break;
+                }
+                PlanificadorDispositivos planificador(*sistema, 2);
+                sistema->paraCadaSensor(agregarSondeo, &planificador);
+                planificador.correr();
+                planificador.imprimirReporte();
+                break;
+            }
+#endif
+            
             case 0: {
                 // Salir del programa
                 printf("\n[Sistema] Cerrando y liberando memoria...\n");